@@ -0,0 +1,321 @@
+#include "benchmarks.h"
+#include "numericalanalysis.h"
+#include "smallmatrix.h"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------------------
+//  Comparación de métodos de intervalo
+//
+//  Cada función del corpus se construye con Function::extract_expression
+//  y se resuelve en el mismo intervalo con todos los métodos. Se reportan
+//  las evaluaciones y el tiempo medio por solución (RootResult::elapsed,
+//  promediado sobre varias repeticiones).
+// ---------------------------------------------------------------------
+
+struct BenchmarkProblem {
+    std::string expression;
+    double      point_a;
+    double      point_b;
+};
+
+static const std::vector<BenchmarkProblem> root_corpus = {
+    {"x^3 - 2x - 5",        2.0,  3.0},
+    {"cos(x) - x",          0.0,  1.0},
+    {"x^10 - 1",            0.0,  1.3},
+    {"exp(x) - 1/x",        0.1,  2.0},
+    {"x*exp(x) - 1",        0.0,  1.0},
+    {"ln(x) + x - 2",       0.5,  3.0},
+    {"tan(x) - 2x",         0.5,  1.5},
+    {"sin(x) - 0.5",        0.0,  1.5},
+    {"x^3",                -1.0,  2.0},
+    {"(x - 1)^5",           0.0,  3.0},
+    {"exp(10x) - 2",       -1.0,  1.0},
+    {"1/x - 0.001",       100.0, 5000.0},
+};
+
+void benchmark_root_finders()
+{
+    const double tolerance  = 1e-12;
+    const int    iterations = 1000;
+    const int    repeats    = 200;
+
+    const char *names[] = {"bisection", "fake_position", "illinois", "brent", "itp"};
+    const int   methods = 5;
+
+    std::cout << "\nEvaluaciones de f por método (tol = " << tolerance << ", * = no convergió)\n";
+    std::cout << std::left << std::setw(20) << "f(x)";
+    for (const char *name : names) std::cout << std::right << std::setw(15) << name;
+    std::cout << "\n";
+
+    std::vector<long>   total_evaluations(methods, 0);
+    std::vector<double> total_seconds(methods, 0.0);
+
+    for (const BenchmarkProblem &problem : root_corpus)
+    {
+        NumericalAnalysis::Function func;
+        func.extract_expression(problem.expression);
+
+        std::cout << std::left << std::setw(20) << problem.expression;
+        for (int m = 0; m < methods; m++)
+        {
+            auto solve = [&]()
+            {
+                double a = problem.point_a, b = problem.point_b;
+                switch (m)
+                {
+                    case 0:  return NumericalAnalysis::bisection(func, a, b, tolerance, iterations);
+                    case 1:  return NumericalAnalysis::fake_position(func, a, b, tolerance, iterations);
+                    case 2:  return NumericalAnalysis::illinois_method(func, a, b, tolerance, iterations);
+                    case 3:  return NumericalAnalysis::brent_method(func, a, b, tolerance, iterations);
+                    default: return NumericalAnalysis::itp_method(func, a, b, tolerance, iterations);
+                }
+            };
+
+            NumericalAnalysis::RootResult result = solve();
+            long evaluations = result.evaluations;
+            bool failed = !result.converged();
+
+            double seconds = 0.0;
+            for (int r = 0; r < repeats; r++) seconds += solve().elapsed;
+
+            total_evaluations[m] += evaluations;
+            total_seconds[m]     += seconds / repeats;
+            std::cout << std::right << std::setw(14) << evaluations << (failed ? '*' : ' ');
+        }
+        std::cout << "\n";
+    }
+
+    std::cout << std::left << std::setw(20) << "total";
+    for (int m = 0; m < methods; m++) std::cout << std::right << std::setw(14) << total_evaluations[m] << ' ';
+    std::cout << "\n" << std::left << std::setw(20) << "tiempo total (us)";
+    for (int m = 0; m < methods; m++)
+        std::cout << std::right << std::setw(14) << std::fixed << std::setprecision(2)
+                  << total_seconds[m] * 1e6 << ' ';
+    std::cout << "\n";
+}
+
+// ---------------------------------------------------------------------
+//  GEMM contra el producto ingenuo
+//
+//  El ingenuo es el triple bucle i-j-k que tenía Matrix::multiply (el
+//  bucle interno baja por las columnas de B). Se reporta GFLOP/s
+//  (2 n^3 flops por producto) con el mejor de varios intentos; el
+//  ingenuo solo hasta n = 512 porque más arriba tarda demasiado.
+// ---------------------------------------------------------------------
+
+static void naive_multiply(const NumericalAnalysis::Matrix &A, const NumericalAnalysis::Matrix &B,
+                           NumericalAnalysis::Matrix &C)
+{
+    for (int i = 0; i < A.getRows(); i++)
+        for (int j = 0; j < B.getCols(); j++)
+        {
+            double sum = 0.0;
+            for (int k = 0; k < A.getCols(); k++)
+                sum += A(i, k) * B(k, j);
+            C(i, j) = sum;
+        }
+}
+
+template <typename Body>
+static double best_seconds(int repeats, Body body)
+{
+    double best = INFINITY;
+    for (int r = 0; r < repeats; r++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+void benchmark_gemm()
+{
+    std::cout << "\nProducto de matrices n x n (GFLOP/s)\n";
+    std::cout << std::left << std::setw(8) << "n" << std::right << std::setw(14) << "ingenuo"
+              << std::setw(14) << "gemm 1 hilo" << std::setw(14) << "gemm" << std::setw(14) << "error" << "\n";
+
+    for (int n : {64, 128, 256, 512, 1024, 2048})
+    {
+        NumericalAnalysis::Matrix A(n, n), B(n, n), C(n, n), R(n, n);
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < n; j++)
+            {
+                A(i, j) = std::sin(i + 2.0 * j);
+                B(i, j) = std::cos(3.0 * i - j);
+            }
+
+        const double flops   = 2.0 * n * n * n;
+        const int    repeats = n <= 256 ? 20 : 3;
+
+        NumericalAnalysis::gemm(1.0, A, B, 0.0, C);     // calentamiento (hilos, páginas de C)
+        double single   = best_seconds(repeats, [&] { NumericalAnalysis::gemm(1.0, A, B, 0.0, C, 1); });
+        double threaded = best_seconds(repeats, [&] { NumericalAnalysis::gemm(1.0, A, B, 0.0, C); });
+
+        std::cout << std::left << std::setw(8) << n << std::right << std::fixed << std::setprecision(2);
+        if (n <= 512)
+        {
+            double naive = best_seconds(1, [&] { naive_multiply(A, B, R); });
+            double error = 0.0;
+            for (int i = 0; i < n; i++)
+                for (int j = 0; j < n; j++)
+                    error = std::max(error, std::abs(R(i, j) - C(i, j)));
+            std::cout << std::setw(14) << flops / naive * 1e-9
+                      << std::setw(14) << flops / single * 1e-9
+                      << std::setw(14) << flops / threaded * 1e-9
+                      << std::setw(14) << std::scientific << std::setprecision(1) << error << "\n";
+        }
+        else
+            std::cout << std::setw(14) << "-" << std::setw(14) << flops / single * 1e-9
+                      << std::setw(14) << flops / threaded * 1e-9 << std::setw(14) << "-" << "\n";
+    }
+}
+
+// ---------------------------------------------------------------------
+//  Sistemas pequeños: SmallLU contra LUDecomposition sobre Matrix
+//
+//  Cada repetición factoriza y resuelve un sistema N×N diagonal
+//  dominante; se cambia un elemento en cada vuelta para que el
+//  compilador no saque la factorización del bucle. Se reporta el tiempo
+//  medio por sistema en nanosegundos.
+// ---------------------------------------------------------------------
+
+template <int N>
+static void benchmark_small_system(int systems)
+{
+    NumericalAnalysis::SmallMatrix<N, N> A;
+    NumericalAnalysis::SmallMatrix<N, 1> b;
+    for (int i = 0; i < N; i++)
+    {
+        for (int j = 0; j < N; j++) A(i, j) = std::sin(1.0 + 7.0 * i * j) + (i == j ? N : 0);
+        b(i, 0) = i + 1.0;
+    }
+    NumericalAnalysis::Matrix Am = A.to_matrix(), bm = b.to_matrix();
+
+    double checksum = 0.0;
+    double fixed = best_seconds(3, [&]
+    {
+        for (int s = 0; s < systems; s++)
+        {
+            A(0, 0) = N + 1e-9 * s;
+            checksum += NumericalAnalysis::SmallLU<N>(A).solve(b)(0, 0);
+        }
+    });
+    const int dynamic_systems = systems / 100;
+    double dynamic = best_seconds(3, [&]
+    {
+        for (int s = 0; s < dynamic_systems; s++)
+        {
+            Am(0, 0) = N + 1e-9 * s;
+            checksum += NumericalAnalysis::LUDecomposition(Am).solve(bm)(0, 0);
+        }
+    });
+
+    std::cout << std::left << std::setw(8) << (std::to_string(N) + "x" + std::to_string(N))
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(14) << fixed / systems * 1e9
+              << std::setw(14) << dynamic / dynamic_systems * 1e9
+              << std::setw(14) << (dynamic / dynamic_systems) / (fixed / systems)
+              << (std::isfinite(checksum) ? "" : "  (!)") << "\n";
+}
+
+void benchmark_small_systems()
+{
+    std::cout << "\nSistemas pequeños, factorizar + resolver (ns por sistema)\n";
+    std::cout << std::left << std::setw(8) << "n" << std::right << std::setw(14) << "SmallLU"
+              << std::setw(14) << "Matrix" << std::setw(14) << "aceleración" << "\n";
+
+    const int systems = 1000000;
+    benchmark_small_system<2>(systems);
+    benchmark_small_system<3>(systems);
+    benchmark_small_system<4>(systems);
+    benchmark_small_system<6>(systems);
+    benchmark_small_system<8>(systems);
+}
+
+// ---------------------------------------------------------------------
+//  Sistemas por lotes: solve_batched (SoA) contra resolver uno por uno
+//
+//  Los mismos count sistemas diagonal dominantes se resuelven con
+//  solve_batched (1 hilo y todos), con un bucle de SmallLU sobre un
+//  arreglo de SmallMatrix (formato AoS) y con
+//  gaussian_elimination_with_regressive_substitution sobre Matrix (solo
+//  los primeros count / 64, es mucho más lento). La última columna es
+//  la diferencia máxima contra este último; debe ser 0, porque usan
+//  las mismas reglas en el mismo orden.
+// ---------------------------------------------------------------------
+
+template <int N>
+static void benchmark_batched_system(std::size_t count)
+{
+    const int cols = N + 1;
+    std::vector<double> augmented(static_cast<std::size_t>(N) * cols * count);
+    std::vector<NumericalAnalysis::SmallMatrix<N, N + 1>> systems(count);
+    for (std::size_t k = 0; k < count; k++)
+        for (int i = 0; i < N; i++)
+            for (int j = 0; j < cols; j++)
+            {
+                double v = std::sin(1.0 + 0.37 * k + 7.0 * i + 3.0 * j) + (i == j ? N : 0);
+                augmented[(static_cast<std::size_t>(i) * cols + j) * count + k] = v;
+                systems[k](i, j) = v;
+            }
+
+    std::vector<double> solutions(static_cast<std::size_t>(N) * count);
+    NumericalAnalysis::solve_batched(N, count, augmented.data(), solutions.data());     // calentamiento
+    double single   = best_seconds(3, [&] { NumericalAnalysis::solve_batched(N, count, augmented.data(), solutions.data(), nullptr, 1); });
+    double threaded = best_seconds(3, [&] { NumericalAnalysis::solve_batched(N, count, augmented.data(), solutions.data()); });
+
+    double checksum = 0.0;
+    double fixed = best_seconds(3, [&]
+    {
+        for (std::size_t k = 0; k < count; k++) checksum += NumericalAnalysis::lu_substitution(systems[k])(0, 0);
+    });
+
+    const std::size_t dynamic_count = count / 64;
+    double error = 0.0;
+    double dynamic = best_seconds(1, [&]
+    {
+        for (std::size_t k = 0; k < dynamic_count; k++)
+        {
+            NumericalAnalysis::Matrix x =
+                NumericalAnalysis::gaussian_elimination_with_regressive_substitution(systems[k]);
+            for (int i = 0; i < N; i++)
+                error = std::max(error, std::abs(x(i, 0) - solutions[static_cast<std::size_t>(i) * count + k]));
+        }
+    });
+
+    std::cout << std::left << std::setw(8) << (std::to_string(N) + "x" + std::to_string(N))
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(14) << single / count * 1e9
+              << std::setw(14) << threaded / count * 1e9
+              << std::setw(14) << fixed / count * 1e9
+              << std::setw(14) << dynamic / dynamic_count * 1e9
+              << std::setw(14) << std::scientific << std::setprecision(1) << error
+              << (std::isfinite(checksum) ? "" : "  (!)") << "\n";
+}
+
+void benchmark_batched_systems()
+{
+    std::cout << "\nSistemas por lotes (ns por sistema)\n";
+    std::cout << std::left << std::setw(8) << "n" << std::right << std::setw(14) << "lote 1 hilo"
+              << std::setw(14) << "lote" << std::setw(14) << "SmallLU" << std::setw(14) << "Matrix"
+              << std::setw(14) << "error" << "\n";
+
+    const std::size_t count = 1 << 18;
+    benchmark_batched_system<3>(count);
+    benchmark_batched_system<4>(count);
+    benchmark_batched_system<6>(count);
+}
+
+void run_benchmarks()
+{
+    benchmark_root_finders();
+    benchmark_gemm();
+    benchmark_small_systems();
+    benchmark_batched_systems();
+}
@@ -0,0 +1,11 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+    // Se ejecutan con ./programa --benchmark
+    void run_benchmarks();
+    void benchmark_root_finders();
+    void benchmark_gemm();
+    void benchmark_small_systems();
+    void benchmark_batched_systems();
+
+#endif
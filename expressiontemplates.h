@@ -0,0 +1,204 @@
+#ifndef EXPRESSIONTEMPLATES_H
+#define EXPRESSIONTEMPLATES_H
+
+#include "numericalanalysis.h"
+
+#include <cmath>
+#include <concepts>
+#include <type_traits>
+
+// ---------------------------------------------------------------------
+//  Funciones conocidas en tiempo de compilación (expression templates)
+//
+//      using namespace NumericalAnalysis::Static;
+//      auto f = 3*pow<2>(x) + sin(pow<3>(x));
+//      double r = NumericalAnalysis::newton_raphson(f, 1.0, 1e-10, 50).root;
+//
+//  La expresión es un tipo: cada nodo guarda a sus hijos por valor y su
+//  operator() se instancia para double (valor), para Dual (derivada en
+//  modo adelante) y para Interval (encierros para isolate_roots), así
+//  que evaluate y derivate_evaluate quedan como código en línea sin
+//  cinta, sin mapa y sin llamadas indirectas. Los objetos ofrecen la
+//  misma interfaz que Function (evaluate, derivate_evaluate,
+//  evaluate_with_derivative) y sirven en todas las plantillas de
+//  numericalanalysis.h.
+// ---------------------------------------------------------------------
+
+namespace NumericalAnalysis::Static {
+
+    // Marca común de todos los nodos
+    struct ExpressionTag {};
+
+    template <typename E>
+    concept Expression = std::derived_from<std::remove_cvref_t<E>, ExpressionTag>;
+
+    // Operando válido en + - * /: un nodo o un número (se vuelve Constant)
+    template <typename E>
+    concept Operand = Expression<E> || std::is_arithmetic_v<std::remove_cvref_t<E>>;
+
+    // x^N con N fijo: la cadena de cuadrados se desenrolla al compilar
+    template <int N, typename T>
+    constexpr T static_pow(T v)
+    {
+        if constexpr (N < 0)       return T{1.0} / static_pow<-N>(v);
+        else if constexpr (N == 0) return T{1.0};
+        else if constexpr (N == 1) return v;
+        else
+        {
+            T half = static_pow<N / 2>(v);
+            if constexpr (N % 2 == 0) return half * half;
+            else                      return half * half * v;
+        }
+    }
+
+    // Interfaz común (CRTP): todo sale de operator()(T) del nodo concreto
+    template <typename Derived>
+    struct Node : ExpressionTag {
+        constexpr double evaluate(double x) const { return self()(x); }
+
+        double derivate_evaluate(double x) const { return self()(Dual{x, 1.0}).derivative; }
+
+        void evaluate_with_derivative(double x, double& fx, double& dfx) const
+        {
+            Dual r = self()(Dual{x, 1.0});
+            fx  = r.value;
+            dfx = r.derivative;
+        }
+
+        Dual evaluate(Dual x) const { return self()(x); }
+
+        Interval evaluate(Interval x) const { return self()(x); }
+
+    private:
+        constexpr const Derived& self() const { return static_cast<const Derived&>(*this); }
+    };
+
+    struct Variable : Node<Variable> {
+        template <typename T>
+        constexpr T operator()(T x) const { return x; }
+    };
+
+    struct Constant : Node<Constant> {
+        double value;
+        constexpr Constant(double v) : value(v) {}
+
+        template <typename T>
+        constexpr T operator()(T) const { return T{value}; }
+    };
+
+    template <typename E>
+    struct Negate : Node<Negate<E>> {
+        E e;
+        constexpr Negate(E e) : e(e) {}
+
+        template <typename T>
+        constexpr T operator()(T x) const { return -e(x); }
+    };
+
+    template <typename L, typename R>
+    struct Sum : Node<Sum<L, R>> {
+        L l; R r;
+        constexpr Sum(L l, R r) : l(l), r(r) {}
+
+        template <typename T>
+        constexpr T operator()(T x) const { return l(x) + r(x); }
+    };
+
+    template <typename L, typename R>
+    struct Difference : Node<Difference<L, R>> {
+        L l; R r;
+        constexpr Difference(L l, R r) : l(l), r(r) {}
+
+        template <typename T>
+        constexpr T operator()(T x) const { return l(x) - r(x); }
+    };
+
+    template <typename L, typename R>
+    struct Product : Node<Product<L, R>> {
+        L l; R r;
+        constexpr Product(L l, R r) : l(l), r(r) {}
+
+        template <typename T>
+        constexpr T operator()(T x) const { return l(x) * r(x); }
+    };
+
+    template <typename L, typename R>
+    struct Quotient : Node<Quotient<L, R>> {
+        L l; R r;
+        constexpr Quotient(L l, R r) : l(l), r(r) {}
+
+        template <typename T>
+        constexpr T operator()(T x) const { return l(x) / r(x); }
+    };
+
+    template <int N, typename E>
+    struct Power : Node<Power<N, E>> {
+        E e;
+        constexpr Power(E e) : e(e) {}
+
+        // En intervalos se usa el rango exacto de x^N, no el producto
+        template <typename T>
+        constexpr T operator()(T x) const
+        {
+            if constexpr (std::is_same_v<T, Interval>) return NumericalAnalysis::pow(e(x), N);
+            else                                       return static_pow<N>(e(x));
+        }
+    };
+
+    // Funciones elementales. El using trae la versión de double; las de
+    // Dual e Interval llegan por ADL desde NumericalAnalysis.
+#define NA_STATIC_UNARY(Name, fn)                                           \
+    template <typename E>                                                   \
+    struct Name : Node<Name<E>> {                                           \
+        E e;                                                                \
+        constexpr Name(E e) : e(e) {}                                       \
+                                                                            \
+        template <typename T>                                               \
+        T operator()(T x) const { using std::fn; return fn(e(x)); }         \
+    };                                                                      \
+                                                                            \
+    template <Expression E>                                                 \
+    constexpr Name<E> fn(E e) { return Name<E>(e); }
+
+    NA_STATIC_UNARY(Sine,        sin)
+    NA_STATIC_UNARY(Cosine,      cos)
+    NA_STATIC_UNARY(Tangent,     tan)
+    NA_STATIC_UNARY(Exponential, exp)
+    NA_STATIC_UNARY(Logarithm,   log)
+    NA_STATIC_UNARY(SquareRoot,  sqrt)
+
+#undef NA_STATIC_UNARY
+
+    template <typename E>
+    constexpr auto as_expression(E e)
+    {
+        if constexpr (Expression<E>) return e;
+        else                         return Constant(static_cast<double>(e));
+    }
+
+    template <typename E>
+    using expression_t = decltype(as_expression(std::declval<E>()));
+
+    template <Operand L, Operand R> requires (Expression<L> || Expression<R>)
+    constexpr auto operator+(L l, R r) { return Sum<expression_t<L>, expression_t<R>>(as_expression(l), as_expression(r)); }
+
+    template <Operand L, Operand R> requires (Expression<L> || Expression<R>)
+    constexpr auto operator-(L l, R r) { return Difference<expression_t<L>, expression_t<R>>(as_expression(l), as_expression(r)); }
+
+    template <Operand L, Operand R> requires (Expression<L> || Expression<R>)
+    constexpr auto operator*(L l, R r) { return Product<expression_t<L>, expression_t<R>>(as_expression(l), as_expression(r)); }
+
+    template <Operand L, Operand R> requires (Expression<L> || Expression<R>)
+    constexpr auto operator/(L l, R r) { return Quotient<expression_t<L>, expression_t<R>>(as_expression(l), as_expression(r)); }
+
+    template <Expression E>
+    constexpr Negate<E> operator-(E e) { return Negate<E>(e); }
+
+    template <int N, Expression E>
+    constexpr Power<N, E> pow(E e) { return Power<N, E>(e); }
+
+    // La variable independiente
+    inline constexpr Variable x{};
+}
+
+#endif
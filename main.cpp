@@ -1,6 +1,8 @@
 #include <iostream>
 #include "numericalanalysis.h"
 #include "menu.h"
+#include "benchmarks.h"
+#include "tests.h"
 
 int main(int argc, char **argv)
 {
@@ -13,6 +15,13 @@ int main(int argc, char **argv)
             helper_function();
             return EXIT_SUCCESS;
         }
+        if (temporal == "--benchmark")
+        {
+            run_benchmarks();
+            return EXIT_SUCCESS;
+        }
+        if (temporal == "--test")
+            return run_tests() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
     }
     bool menu_continue = true;
     int menu_option;
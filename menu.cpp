@@ -4,6 +4,8 @@
 #include <iomanip>
 #include <limits>
 #include <stdexcept>
+#include <vector>
+#include <cmath>
 
 void helper_function(){
     std::cout << "helper" << std::endl;
@@ -48,7 +50,7 @@ static NumericalAnalysis::Function read_function()
     }
 }
 
-double call_bisection()
+NumericalAnalysis::RootResult call_bisection()
 {
     std::cin.ignore();
     NumericalAnalysis::Function func = read_function();
@@ -59,7 +61,18 @@ double call_bisection()
     if (func.evaluate(point_a) * func.evaluate(point_b) > 0)
     {
         std::cerr << "f(a) y f(b) deben tener signos opuestos para garantizar una raíz en [a, b].\n";
-        return -1;
+
+        // Sugerencia: subintervalos donde el encierro de f contiene 0
+        double width = std::abs(point_b - point_a) * 1e-3;
+        std::vector<NumericalAnalysis::Interval> boxes =
+            NumericalAnalysis::isolate_roots(func, point_a, point_b, width, 2000);
+        if (!boxes.empty())
+        {
+            std::cout << "  Posibles subintervalos con raíz:\n";
+            for (const NumericalAnalysis::Interval &box : boxes)
+                std::cout << "    [" << box.lo << ", " << box.hi << "]\n";
+        }
+        return {.status = NumericalAnalysis::RootStatus::NoSignChange};
     }
 
     double tolerance = 0;
@@ -79,7 +92,7 @@ double call_bisection()
     return NumericalAnalysis::bisection(func, point_a, point_b, tolerance, iterations);
 }
 
-double call_fixed_point()
+NumericalAnalysis::RootResult call_fixed_point()
 {
     std::cin.ignore();
     NumericalAnalysis::Function func = read_function();
@@ -103,7 +116,7 @@ double call_fixed_point()
     return NumericalAnalysis::fixed_point(func, initial_point, tolerance, iterations);
 }
 
-double call_fake_position()
+NumericalAnalysis::RootResult call_fake_position()
 {
     std::cin.ignore();
     NumericalAnalysis::Function func = read_function();
@@ -114,7 +127,7 @@ double call_fake_position()
     if (func.evaluate(point_a) * func.evaluate(point_b) > 0)
     {
         std::cerr << "f(a) y f(b) deben tener signos opuestos para que el método de posición falsa funcione.\n";
-        return -1;
+        return {.status = NumericalAnalysis::RootStatus::NoSignChange};
     }
 
     double tolerance = 0;
@@ -134,7 +147,7 @@ double call_fake_position()
     return NumericalAnalysis::fake_position(func, point_a, point_b, tolerance, iterations);
 }
 
-double call_newton_raphson()
+NumericalAnalysis::RootResult call_newton_raphson()
 {
     std::cin.ignore();
     NumericalAnalysis::Function func = read_function();
@@ -158,7 +171,7 @@ double call_newton_raphson()
     return NumericalAnalysis::newton_raphson(func, initial_point, tolerance, iterations);
 }
 
-double call_secant_method()
+NumericalAnalysis::RootResult call_secant_method()
 {
     std::cin.ignore();
     NumericalAnalysis::Function func = read_function();
@@ -208,25 +221,17 @@ static void print_solution(const NumericalAnalysis::Matrix& result)
     std::cout << "\n";
 }
 
-static void print_determinant(NumericalAnalysis::Matrix m)
+static void print_determinant(NumericalAnalysis::ConstMatrixView m)
 {
     int r = m.getRows();
     int c = m.getCols();
     if (r == 0) return;
 
-    if (c == r)
+    // A (o el bloque A de [A|b]) entra como vista, sin copiarla aparte
+    if (c == r || c == r + 1)
     {
         std::cout << "det(A) = " << std::fixed << std::setprecision(6)
-                  << m.determinant() << "\n";
-    }
-    else if (c == r + 1)
-    {
-        NumericalAnalysis::Matrix A(r, r);
-        for (int i = 0; i < r; i++)
-            for (int j = 0; j < r; j++)
-                A.set(i, j, m.get(i, j));
-        std::cout << "det(A) = " << std::fixed << std::setprecision(6)
-                  << A.determinant() << "\n";
+                  << NumericalAnalysis::LUDecomposition(m.block(0, 0, r, r)).determinant() << "\n";
     }
 }
 
@@ -259,13 +264,12 @@ static NumericalAnalysis::Matrix read_augmented_matrix()
         std::cout << "\nIngrese el vector b (" << r << " valores):\n";
 
         NumericalAnalysis::Matrix aug(r, r + 1);
-        for (int i = 0; i < r; i++)
-            for (int j = 0; j < r; j++)
-                aug.set(i, j, m.get(i, j));
+        aug.block(0, 0, r, r).copy_from(m);
 
+        NumericalAnalysis::MatrixView b = aug.column_view(r);
         for (int i = 0; i < r; i++)
-            aug.set(i, r, read_value<double>(
-                "  b_" + std::to_string(i + 1) + " = "));
+            b(i, 0) = read_value<double>(
+                "  b_" + std::to_string(i + 1) + " = ");
 
         std::cout << "\nMatriz aumentada [A|b]:\n";
         aug.print();
@@ -323,12 +327,11 @@ void call_gaussian_elimination()
         {
             std::cout << "\nIngrese el vector b (" << r << " valores):\n";
             NumericalAnalysis::Matrix aug(r, r + 1);
+            aug.block(0, 0, r, r).copy_from(m);
+            NumericalAnalysis::MatrixView b = aug.column_view(r);
             for (int i = 0; i < r; i++)
-                for (int j = 0; j < r; j++)
-                    aug.set(i, j, m.get(i, j));
-            for (int i = 0; i < r; i++)
-                aug.set(i, r, read_value<double>(
-                    "  b_" + std::to_string(i + 1) + " = "));
+                b(i, 0) = read_value<double>(
+                    "  b_" + std::to_string(i + 1) + " = ");
 
             NumericalAnalysis::Matrix result =
                 NumericalAnalysis::gaussian_elimination_with_regressive_substitution(aug);
@@ -378,34 +381,34 @@ void call_lu_substitution()
         m.print();
         print_determinant(m);
 
-        NumericalAnalysis::Matrix L, U;
-        NumericalAnalysis::lu_factorization(m, L, U);
-        if (L.getRows() == 0) return;
+        // Se factoriza una vez; cada vector b después cuesta O(n²)
+        NumericalAnalysis::LUDecomposition lu(m);
+        if (lu.singular())
+        {
+            std::cerr << "[lu_factorization] Matriz singular, no se puede factorizar\n";
+            return;
+        }
 
         std::cout << "\nMatriz L:\n";
-        L.print();
+        lu.lower().print();
         std::cout << "\nMatriz U:\n";
-        U.print();
-
-        std::cout << "\n¿Desea resolver un sistema Ax = b? (s/n): ";
-        char opt;
-        std::cin >> opt;
-        flush_cin();
+        lu.upper().print();
 
-        if (opt == 's' || opt == 'S')
+        while (true)
         {
+            std::cout << "\n¿Desea resolver un sistema Ax = b? (s/n): ";
+            char opt;
+            std::cin >> opt;
+            flush_cin();
+            if (opt != 's' && opt != 'S') break;
+
             std::cout << "\nIngrese el vector b (" << r << " valores):\n";
-            NumericalAnalysis::Matrix aug(r, r + 1);
-            for (int i = 0; i < r; i++)
-                for (int j = 0; j < r; j++)
-                    aug.set(i, j, m.get(i, j));
+            NumericalAnalysis::Matrix b(r, 1);
             for (int i = 0; i < r; i++)
-                aug.set(i, r, read_value<double>(
+                b.set(i, 0, read_value<double>(
                     "  b_" + std::to_string(i + 1) + " = "));
 
-            NumericalAnalysis::Matrix result =
-                NumericalAnalysis::lu_substitution(aug);
-            print_solution(result);
+            print_solution(lu.solve(b));
         }
     }
     else if (c == r + 1)
@@ -414,24 +417,19 @@ void call_lu_substitution()
         m.print();
         print_determinant(m);
 
-        NumericalAnalysis::Matrix A(r, r);
-        for (int i = 0; i < r; i++)
-            for (int j = 0; j < r; j++)
-                A.set(i, j, m.get(i, j));
-
-        NumericalAnalysis::Matrix L, U;
-        NumericalAnalysis::lu_factorization(A, L, U);
-        if (L.getRows() > 0)
+        NumericalAnalysis::LUDecomposition lu(m.block(0, 0, r, r));
+        if (lu.singular())
         {
-            std::cout << "\nMatriz L:\n";
-            L.print();
-            std::cout << "\nMatriz U:\n";
-            U.print();
+            std::cerr << "[lu_substitution] Matriz singular, no se puede factorizar\n";
+            return;
         }
 
-        NumericalAnalysis::Matrix result =
-            NumericalAnalysis::lu_substitution(m);
-        print_solution(result);
+        std::cout << "\nMatriz L:\n";
+        lu.lower().print();
+        std::cout << "\nMatriz U:\n";
+        lu.upper().print();
+
+        print_solution(lu.solve(m.column_view(r)));
     }
     else
     {
@@ -593,7 +591,19 @@ void print_menu(){
     std::cout << "Opción: ";
 }
 
-void check_error(double value){
-    if (value == -1) std::cout << "No se pudo encontrar resultado con la tolerancia propuesta." << std::endl;
-    else std::cout << "El resultado de la operación es: " << value << std::endl;
-}
\ No newline at end of file
+void check_error(const NumericalAnalysis::RootResult& result){
+    if (!result.converged())
+        std::cout << "No se pudo encontrar resultado con la tolerancia propuesta ("
+                  << NumericalAnalysis::to_string(result.status) << ")." << std::endl;
+    else std::cout << "El resultado de la operación es: " << result.root << std::endl;
+
+    if (result.evaluations > 0)
+    {
+        std::cout << "  Iteraciones: " << result.iterations
+                  << " | evaluaciones de f: " << result.evaluations;
+        if (result.derivative_evaluations > 0)
+            std::cout << " (con derivada: " << result.derivative_evaluations << ")";
+        std::cout << "\n  |f(x)| = " << result.residual
+                  << " | tiempo: " << result.elapsed * 1e6 << " us" << std::endl;
+    }
+}
@@ -1,12 +1,14 @@
 #ifndef MENU_H
 #define MENU_H
 
+#include "numericalanalysis.h"
+
     void helper_function();
-    double call_bisection();
-    double call_fixed_point();
-    double call_fake_position();
-    double call_newton_raphson();
-    double call_secant_method();
+    NumericalAnalysis::RootResult call_bisection();
+    NumericalAnalysis::RootResult call_fixed_point();
+    NumericalAnalysis::RootResult call_fake_position();
+    NumericalAnalysis::RootResult call_newton_raphson();
+    NumericalAnalysis::RootResult call_secant_method();
 
     void call_regressive_substitution();
     void call_gaussian_elimination();
@@ -19,6 +21,6 @@
     void call_simpson_rule();
 
     void print_menu();
-    void check_error(double value);
+    void check_error(const NumericalAnalysis::RootResult& result);
 
 #endif
\ No newline at end of file
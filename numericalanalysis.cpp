@@ -1,6 +1,5 @@
 #include "numericalanalysis.h"
 #include <cmath>
-#include <regex>
 #include <string>
 #include <vector>
 #include <iomanip>
@@ -8,774 +7,3454 @@
 #include <fstream>
 #include <algorithm>
 #include <stdexcept>
+#include <charconv>
+#include <string_view>
+#include <type_traits>
+#include <tuple>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+// Núcleos AVX2 con selección en tiempo de ejecución (evaluate_many)
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NA_VECTOR_MATH 1
+#endif
+#if defined(__AVX512F__) || (defined(__AVX2__) && defined(__FMA__)) || defined(NA_VECTOR_MATH)
+#include <immintrin.h>
+#endif
 
 namespace NumericalAnalysis
 {
 
-    static bool parse_exp_arg(const std::string &arg, double &a, int &n, double &c)
+    // Avanza sobre un decimal \d+\.?\d* | \.?\d+ ; false si no hay ninguno en pos
+    static bool scan_number(std::string_view text, std::size_t &pos)
+    {
+        std::size_t start = pos, digits = 0;
+        while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos]))) { pos++; digits++; }
+        if (pos < text.size() && text[pos] == '.') pos++;
+        while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos]))) { pos++; digits++; }
+        if (digits == 0) pos = start;
+        return digits > 0;
+    }
+
+    static double to_double(std::string_view text)
+    {
+        double value = 0.0;
+        std::from_chars(text.data(), text.data() + text.size(), value);
+        return value;
+    }
+
+    static bool parse_exp_arg(std::string_view arg, double &a, int &n, double &c)
     {
         // g(x) accepted forms:
         //   x, -x, 3x, -3x, 2x^2, -0.5x^3, 4
-        static const std::regex arg_re(
-            R"(^([+-]?)(?:(\d+\.?\d*|\.?\d+)?x(?:\^(\d+))?|(\d+\.?\d*|\.?\d+))$)");
+        std::size_t pos = 0;
+        bool negative = false;
+        if (pos < arg.size() && (arg[pos] == '+' || arg[pos] == '-'))
+            negative = arg[pos++] == '-';
 
-        std::smatch m;
-        if (!std::regex_match(arg, m, arg_re)) return false;
+        std::size_t number_start = pos;
+        bool has_number = scan_number(arg, pos);
+        std::string_view number = arg.substr(number_start, pos - number_start);
 
-        std::string sign = m[1].str();
-        std::string coef_digits = m[2].str();
-        std::string degree_str = m[3].str();
-        std::string constant_str = m[4].str();
-
-        if (!constant_str.empty())
+        if (pos == arg.size())
         {
-            c = std::stod(constant_str);
-            if (sign == "-") c = -c;
+            if (!has_number) return false;
+            c = negative ? -to_double(number) : to_double(number);
             a = 0.0;
             n = 0;
             return true;
         }
 
-        a = coef_digits.empty() ? 1.0 : std::stod(coef_digits);
-        if (sign == "-") a = -a;
-        n = degree_str.empty() ? 1 : std::stoi(degree_str);
+        if (arg[pos++] != 'x') return false;
+        n = 1;
+        if (pos < arg.size())
+        {
+            if (arg[pos++] != '^' || pos == arg.size()) return false;
+            n = 0;
+            for (; pos < arg.size(); pos++)
+            {
+                if (!std::isdigit(static_cast<unsigned char>(arg[pos]))) return false;
+                n = n * 10 + (arg[pos] - '0');
+            }
+        }
+        a = has_number ? to_double(number) : 1.0;
+        if (negative) a = -a;
         c = 0.0;
         return true;
     }
 
-    static double eval_arg(const std::string &arg, double x)
+    // x^n con n ≥ 0 por cuadrados sucesivos (evita std::pow en el ciclo caliente)
+    static inline double ipow(double x, int n)
     {
-        if (arg.size() > 2 && arg[0] == 'x' && arg[1] == '^')
-            return std::pow(x, std::stoi(arg.substr(2)));
-
-        std::cerr << "[eval_arg] Unsupported argument: \"" << arg << "\"\n";
-        return 0.0;
+        double result = 1.0;
+        while (n > 0)
+        {
+            if (n & 1) result *= x;
+            x *= x;
+            n >>= 1;
+        }
+        return result;
     }
 
-    static double eval_arg_deriv(const std::string &arg, double x)
+    // g[i] = x[i]^n, misma cadena de cuadrados para todos los puntos del bloque
+    static void power_block(const double *x, double *g, double *base, std::size_t len, int n)
     {
-        if (arg.size() > 2 && arg[0] == 'x' && arg[1] == '^')
+        for (std::size_t i = 0; i < len; i++) { g[i] = 1.0; base[i] = x[i]; }
+        while (n > 0)
         {
-            int n = std::stoi(arg.substr(2));
-            if (n == 0) return 0.0;
-            return n * std::pow(x, n - 1);
+            if (n & 1)
+                for (std::size_t i = 0; i < len; i++) g[i] *= base[i];
+            n >>= 1;
+            if (n > 0)
+                for (std::size_t i = 0; i < len; i++) base[i] *= base[i];
         }
-        return 0.0;
     }
 
-    bool Function::valid_key(const std::string &key) const
-    {
-        static const std::regex poly_key_re(R"(^x\^\d+$)");
-        if (std::regex_match(key, poly_key_re)) return true;
+    // =====================================================================
+    //  Expresiones generales
+    //
+    //  Parser descendente recursivo que construye el árbol (ExprNode) y
+    //  los evaluadores de la cinta resultante: escalar, dual, por bloques
+    //  y por series de Taylor.
+    // =====================================================================
+
+    // -----------------------------------------------------------------
+    //  Gramática (los espacios se ignoran):
+    //
+    //    sum     := product (('+' | '-') product)*
+    //    product := unary (('*' | '/') unary | power)*     // 3x, 2sin(x)
+    //    unary   := ('+' | '-') unary | power
+    //    power   := primary ('^' unary)?                    // asociativa a derecha
+    //    primary := number | 'x' | 'pi' | 'e' | func '(' sum ')' | '(' sum ')'
+    //    number  := digits ('.' digits)? (('e' | 'E') ('+' | '-')? digits)?
+    //    func    := sin | cos | tan | exp | ln | log | sqrt
+    //
+    //  Una 'e' pegada a un número y seguida de dígitos es el exponente del
+    //  literal: "2.5e-3x" es 0.0025·x. Para la constante, "2e - 3x" o "2*e".
+    //
+    //  "e^(...)" se construye directamente como exp(...). Un exponente
+    //  constante entero genera PowInt (potencia por cuadrados).
+    // -----------------------------------------------------------------
 
-        // Trig key must have normalised arg, e.g. "sin(x^2)" — never bare "sin(x)"
-        static const std::regex trig_key_re(R"(^(sin|cos|tan)\(x\^\d+\)$)");
-        if (std::regex_match(key, trig_key_re)) return true;
+    // Cota de |n| en PowInt: los evaluadores hacen static_cast<int>(n) y
+    // powi niega n, así que tiene que caber holgado en int
+    constexpr double MAX_INT_EXPONENT = 1e6;
+    static_assert(MAX_INT_EXPONENT < std::numeric_limits<int>::max());
 
-        static const std::regex exp_key_re(
-            R"(^exp\(([+-]?)(?:(\d+\.?\d*|\.?\d+)?x(?:\^\d+)?|(\d+\.?\d*|\.?\d+))\)$)");
-        return std::regex_match(key, exp_key_re);
+    static bool integer_exponent(double n)
+    {
+        return n == std::floor(n) && std::abs(n) <= MAX_INT_EXPONENT;
     }
 
-    double Function::evaluate_key(const std::string &key, double x) const
+    class ExpressionParser
     {
-        if (key.size() > 2 && key[0] == 'x' && key[1] == '^')
-            return std::pow(x, std::stoi(key.substr(2)));
+    public:
+        ExpressionParser(std::string_view source, std::vector<ExprNode> &nodes)
+            : src(source), nodes(nodes) {}
 
-        static const std::regex trig_key_re(R"(^(sin|cos|tan)\((x\^\d+)\)$)");
-        static const std::regex exp_key_re(
-            R"(^exp\((([+-]?)(?:(\d+\.?\d*|\.?\d+)?x(?:\^(\d+))?|(\d+\.?\d*|\.?\d+)))\)$)");
-        std::smatch m;
-        if (std::regex_match(key, m, trig_key_re))
+        int parse()
         {
-            double av = eval_arg(m[2].str(), x);
-            const std::string &func = m[1].str();
-            if (func == "sin") return std::sin(av);
-            if (func == "cos") return std::cos(av);
-            if (func == "tan") return std::tan(av);
+            int root = parse_sum();
+            if (peek() != '\0')
+                fail(std::string("unexpected character '") + src[pos] + "'");
+            return root;
         }
 
-        if (std::regex_match(key, m, exp_key_re))
+    private:
+        std::string_view        src;
+        std::size_t             pos = 0;
+        std::vector<ExprNode>  &nodes;
+
+        [[noreturn]] void fail(const std::string &message) const
         {
-            std::string inner = m[1].str();
-            double a = 0.0, c = 0.0;
-            int n = 0;
-            if (parse_exp_arg(inner, a, n, c))
-            {
-                double gx = (a == 0.0) ? c : a * std::pow(x, n);
-                return std::exp(gx);
-            }
+            throw std::invalid_argument(
+                "[Function::extract_expression] " + message + " at position "
+                + std::to_string(pos) + " in \"" + std::string(src) + "\"");
         }
 
-        std::cerr << "[Function::evaluate_key] Unknown key: \"" << key << "\"\n";
-        return 0.0;
-    }
+        char peek()
+        {
+            while (pos < src.size() && std::isspace(static_cast<unsigned char>(src[pos]))) pos++;
+            return pos < src.size() ? src[pos] : '\0';
+        }
 
-    Function::Function() {}
+        bool accept(std::string_view word)
+        {
+            if (src.substr(pos, word.size()) != word) return false;
+            pos += word.size();
+            return true;
+        }
 
-    double Function::evaluate(double x) const
-    {
-        double result = 0.0;
-        for (const auto &[key, coef] : coeff)
-            result += static_cast<double>(coef) * evaluate_key(key, x);
-        return result;
-    }
+        int emit(ExprOp op, int lhs = -1, int rhs = -1, double value = 0.0)
+        {
+            nodes.push_back({op, lhs, rhs, value});
+            return static_cast<int>(nodes.size()) - 1;
+        }
 
-    // -------------------------------------------------------------------------
-    //  derivate_evaluate
-    //
-    //    d/dx [ c * sin(g(x)) ] =  c * cos(g(x)) * g'(x)
-    //    d/dx [ c * cos(g(x)) ] = -c * sin(g(x)) * g'(x)
-    //    d/dx [ c * tan(g(x)) ] =  c * sec²(g(x)) * g'(x)
-    //    d/dx [ c * x^N ]       =  c * N * x^(N-1)
-    // -------------------------------------------------------------------------
+        static bool starts_primary(char c)
+        {
+            return std::isdigit(static_cast<unsigned char>(c)) || c == '.' || c == '('
+                || std::isalpha(static_cast<unsigned char>(c));
+        }
 
-    double Function::derivate_evaluate(double x) const
-    {
-        double result = 0.0;
+        int parse_sum()
+        {
+            int lhs = parse_product();
+            for (char c = peek(); c == '+' || c == '-'; c = peek())
+            {
+                pos++;
+                int rhs = parse_product();
+                lhs = emit(c == '+' ? ExprOp::Add : ExprOp::Sub, lhs, rhs);
+            }
+            return lhs;
+        }
+
+        int parse_product()
+        {
+            int lhs = parse_unary();
+            while (true)
+            {
+                char c = peek();
+                if (c == '*' || c == '/')
+                {
+                    pos++;
+                    int rhs = parse_unary();
+                    lhs = emit(c == '*' ? ExprOp::Mul : ExprOp::Div, lhs, rhs);
+                }
+                else if (starts_primary(c))
+                    lhs = emit(ExprOp::Mul, lhs, parse_power());
+                else
+                    return lhs;
+            }
+        }
 
-        static const std::regex trig_key_re(R"(^(sin|cos|tan)\((x\^\d+)\)$)");
-        static const std::regex exp_key_re(
-            R"(^exp\((([+-]?)(?:(\d+\.?\d*|\.?\d+)?x(?:\^(\d+))?|(\d+\.?\d*|\.?\d+)))\)$)");
+        int parse_unary()
+        {
+            char c = peek();
+            if (c == '-') { pos++; return emit(ExprOp::Neg, parse_unary()); }
+            if (c == '+') { pos++; return parse_unary(); }
+            return parse_power();
+        }
 
-        for (const auto &[key, coef] : coeff)
+        int parse_power()
         {
-            double c = static_cast<double>(coef);
+            int base = parse_primary();
+            if (peek() != '^') return base;
+            pos++;
+            return make_power(base, parse_unary());
+        }
 
-            std::smatch m;
-            if (std::regex_match(key, m, trig_key_re))
+        // Exponente constante entero (n, o -n) al final de la cinta -> PowInt
+        // si |n| ≤ MAX_INT_EXPONENT; si no, Pow general
+        int make_power(int base, int exponent)
+        {
+            const ExprNode &e = nodes[exponent];
+            double n = 0.0;
+            int first = exponent;
+            if (e.op == ExprOp::Const)
+                n = e.value;
+            else if (e.op == ExprOp::Neg && nodes[e.lhs].op == ExprOp::Const && e.lhs == exponent - 1)
             {
-                const std::string &func = m[1].str();
-                const std::string &arg  = m[2].str();
+                n = -nodes[e.lhs].value;
+                first = e.lhs;
+            }
+            else
+                return emit(ExprOp::Pow, base, exponent);
 
-                double gx  = eval_arg(arg, x);      
-                double gpx = eval_arg_deriv(arg, x); 
+            if (!integer_exponent(n))
+                return emit(ExprOp::Pow, base, exponent);
 
-                if (func == "sin")
-                    result += c * std::cos(gx) * gpx;
-                else if (func == "cos")
-                    result += c * -std::sin(gx) * gpx;
-                else if (func == "tan")
+            nodes.resize(first);
+            return emit(ExprOp::PowInt, base, -1, n);
+        }
+
+        int parse_primary()
+        {
+            char c = peek();
+            if (c == '\0') fail("expected an expression");
+
+            if (std::isdigit(static_cast<unsigned char>(c)) || c == '.')
+            {
+                std::size_t start = pos;
+                while (pos < src.size() && std::isdigit(static_cast<unsigned char>(src[pos]))) pos++;
+                if (pos < src.size() && src[pos] == '.') pos++;
+                while (pos < src.size() && std::isdigit(static_cast<unsigned char>(src[pos]))) pos++;
+                // Exponente decimal (1e5, 2.5e-3, 4E+2) solo si le siguen dígitos:
+                // "2e^x" y "3e" siguen siendo productos con la constante e
+                if (pos < src.size() && (src[pos] == 'e' || src[pos] == 'E'))
                 {
-                    double sec = 1.0 / std::cos(gx);
-                    result += c * sec * sec * gpx;
+                    std::size_t digits = pos + 1;
+                    if (digits < src.size() && (src[digits] == '+' || src[digits] == '-')) digits++;
+                    if (digits < src.size() && std::isdigit(static_cast<unsigned char>(src[digits])))
+                    {
+                        pos = digits;
+                        while (pos < src.size() && std::isdigit(static_cast<unsigned char>(src[pos]))) pos++;
+                    }
                 }
-                continue;
+                double value = 0.0;
+                auto [end, ec] = std::from_chars(src.data() + start, src.data() + pos, value);
+                if (ec != std::errc() || end != src.data() + pos) { pos = start; fail("invalid number"); }
+                return emit(ExprOp::Const, -1, -1, value);
             }
 
-            if (key.size() > 2 && key[0] == 'x' && key[1] == '^')
+            if (c == '(')
             {
-                int degree = std::stoi(key.substr(2));
-                if (degree == 0) continue; 
-                result += c * degree * std::pow(x, degree - 1);
-                continue;
+                pos++;
+                int inner = parse_sum();
+                if (peek() != ')') fail("expected ')'");
+                pos++;
+                return inner;
             }
 
-            if (std::regex_match(key, m, exp_key_re))
+            static const std::pair<std::string_view, ExprOp> functions[] = {
+                {"sqrt", ExprOp::Sqrt}, {"sin", ExprOp::Sin}, {"cos", ExprOp::Cos},
+                {"tan",  ExprOp::Tan},  {"exp", ExprOp::Exp}, {"log", ExprOp::Ln},
+                {"ln",   ExprOp::Ln},
+            };
+            for (const auto &[name, op] : functions)
             {
-                std::string inner = m[1].str();
-                double a = 0.0, k = 0.0;
-                int n = 0;
-                if (!parse_exp_arg(inner, a, n, k))
+                if (!accept(name)) continue;
+                if (peek() != '(')
                 {
-                    std::cerr << "[Function::derivate_evaluate] Invalid exp arg: \""
-                              << inner << "\"\n";
-                    continue;
+                    if (op == ExprOp::Sin || op == ExprOp::Cos || op == ExprOp::Tan)
+                        throw std::invalid_argument(
+                            "[Function::extract_expression] Trigonometric functions require "
+                            "a parenthesised argument, e.g. sin(x) or cos(x^2).");
+                    fail(std::string(name) + " requires a parenthesised argument");
                 }
+                pos++;
+                int arg = parse_sum();
+                if (peek() != ')') fail("expected ')'");
+                pos++;
+                return emit(op, arg);
+            }
 
-                // g(x) = a*x^n + k  => g'(x) = a*n*x^(n-1), or 0 if constant
-                double gx  = (a == 0.0) ? k : a * std::pow(x, n);
-                double gpx = (a == 0.0 || n == 0) ? 0.0 : a * n * std::pow(x, n - 1);
-                result += c * std::exp(gx) * gpx;
-                continue;
+            if (accept("pi")) return emit(ExprOp::Const, -1, -1, M_PI);
+            if (accept("x"))  return emit(ExprOp::X);
+            if (accept("e"))
+            {
+                if (peek() != '^') return emit(ExprOp::Const, -1, -1, M_E);
+                pos++;
+                return emit(ExprOp::Exp, parse_unary());
             }
 
-            std::cerr << "[Function::derivate_evaluate] Unknown key: \"" << key << "\"\n";
+            fail(std::string("unexpected character '") + c + "'");
         }
+    };
 
-        return result;
-    }
+    // -----------------------------------------------------------------
+    //  Aritmética de series de Taylor truncadas a K coeficientes.
+    //  Las salidas nunca pueden compartir memoria con las entradas.
+    // -----------------------------------------------------------------
 
-    float Function::get(const std::string &key) const
+    // sin y cos del mismo argumento en una llamada: sincos de glibc reduce el
+    // argumento una sola vez. Sin glibc quedan las dos llamadas de siempre.
+    static inline void sincos_value(double a, double &s, double &c)
     {
-        auto it = coeff.find(key);
-        return (it != coeff.end()) ? it->second : 0.0f;
+#if defined(__GLIBC__)
+        ::sincos(a, &s, &c);
+#else
+        s = std::sin(a);
+        c = std::cos(a);
+#endif
     }
 
-    void Function::update(const std::string &key, float val)
+    static void series_mul(const double *a, const double *b, double *c, int K)
     {
-        if (!valid_key(key))
+        for (int k = 0; k < K; k++)
         {
-            std::cerr << "[Function::update] Invalid key: \"" << key << "\"\n";
-            return;
+            double acc = 0.0;
+            for (int j = 0; j <= k; j++) acc += a[j] * b[k - j];
+            c[k] = acc;
         }
-        auto it = coeff.find(key);
-        if (it != coeff.end())
-            it->second = val;
-        else
-            std::cout << "[Function::update] Term \"" << key
-                      << "\" does not exist; use add() instead.\n";
     }
 
-    void Function::add(const std::string &key, float val)
+    static void series_div(const double *a, const double *b, double *q, int K)
     {
-        if (!valid_key(key))
+        for (int k = 0; k < K; k++)
         {
-            std::cerr << "[Function::add] Invalid key: \"" << key << "\"\n";
-            return;
+            double acc = a[k];
+            for (int j = 0; j < k; j++) acc -= q[j] * b[k - j];
+            q[k] = acc / b[0];
         }
-        if (coeff.count(key))
-            std::cout << "[Function::add] Term \"" << key
-                      << "\" already exists; use update() to change it.\n";
-        else
-            coeff.emplace(key, val);
     }
 
-    // -------------------------------------------------------------------------
-    //  extract_expression
-    //
-    //  Parses compact expressions such as:
-    //    "3x^2 + 2sin(x) - 5cos(x^2) + tan(x^3) - 7"
-    //
-    //  RULES
-    //  -----
-    //  • Trig functions MUST be followed by a parenthesised monomial argument.
-    //    Writing bare "sin", "cos", or "tan" without parens throws std::invalid_argument.
-    //  • The argument inside the parens must be  x  or  x^N.
-    //  • "x" inside parens is normalised to "x^1" so map keys are always "func(x^N)".
-    //  • Arguments with inner +/- (e.g. sin(x+1)) are not supported.
-    // -------------------------------------------------------------------------
-
-    void Function::extract_expression(const std::string &expression)
+    static void series_sincos(const double *u, double *s, double *c, int K)
     {
-        std::string expr = expression;
-        expr.erase(std::remove_if(expr.begin(), expr.end(), ::isspace), expr.end());
-
-        static const std::regex bare_trig_re(R"((sin|cos|tan)(?!\())");
-        if (std::regex_search(expr, bare_trig_re))
-            throw std::invalid_argument(
-                "[Function::extract_expression] Trigonometric functions require "
-                "a parenthesised argument, e.g. sin(x) or cos(x^2).");
-
-        std::vector<std::string> tokens;
+        sincos_value(u[0], s[0], c[0]);
+        for (int k = 1; k < K; k++)
         {
-            std::string current;
-            int depth = 0;
-            for (std::size_t i = 0; i < expr.size(); ++i)
+            double ss = 0.0, cc = 0.0;
+            for (int j = 1; j <= k; j++)
             {
-                char c = expr[i];
-                if (c == '(') ++depth;
-                else if (c == ')') --depth;
-
-                if ((c == '+' || c == '-') && depth == 0 && i != 0)
-                {
-                    tokens.push_back(current);
-                    current.clear();
-                }
-                current += c;
+                ss += j * u[j] * c[k - j];
+                cc += j * u[j] * s[k - j];
             }
-            if (!current.empty()) tokens.push_back(current);
+            s[k] =  ss / k;
+            c[k] = -cc / k;
         }
+    }
 
-        static const std::regex trig_re(
-            R"(^([+-]?)(\d+\.?\d*|\.?\d+)?(sin|cos|tan)\((x(?:\^(\d+))?)\)$)");
-
-        static const std::regex exp_re(
-            R"(^([+-]?)(\d+\.?\d*|\.?\d+)?e\^\((([+-]?)(?:(\d+\.?\d*|\.?\d+)?x(?:\^(\d+))?|(\d+\.?\d*|\.?\d+)))\)$)");
-
-        static const std::regex poly_re(
-            R"(^([+-]?)(\d+\.?\d*|\.?\d+)?(x?)(?:\^(\d+))?$)");
-
-        for (const std::string &term : tokens)
+    static void series_exp(const double *u, double *e, int K)
+    {
+        e[0] = std::exp(u[0]);
+        for (int k = 1; k < K; k++)
         {
-            std::smatch m;
-
-            if (std::regex_match(term, m, trig_re))
-            {
-                std::string sign   = m[1].str();
-                std::string digits = m[2].str();
-                std::string func   = m[3].str(); 
-                std::string arg    = m[4].str(); 
-                std::string exp    = m[5].str(); 
+            double acc = 0.0;
+            for (int j = 1; j <= k; j++) acc += j * u[j] * e[k - j];
+            e[k] = acc / k;
+        }
+    }
 
-                std::string norm_arg = exp.empty() ? "x^1" : ("x^" + exp);
+    static void series_ln(const double *u, double *l, int K)
+    {
+        l[0] = std::log(u[0]);
+        for (int k = 1; k < K; k++)
+        {
+            double acc = 0.0;
+            for (int j = 1; j < k; j++) acc += j * l[j] * u[k - j];
+            l[k] = (u[k] - acc / k) / u[0];
+        }
+    }
 
-                float value = digits.empty() ? 1.0f : std::stof(digits);
-                if (sign == "-") value = -value;
+    static void series_sqrt(const double *u, double *r, int K)
+    {
+        r[0] = std::sqrt(u[0]);
+        for (int k = 1; k < K; k++)
+        {
+            double acc = 0.0;
+            for (int j = 1; j < k; j++) acc += r[j] * r[k - j];
+            r[k] = (u[k] - acc) / (2.0 * r[0]);
+        }
+    }
 
-                std::string key = func + "(" + norm_arg + ")";
-                if (coeff.count(key)) coeff[key] += value;
-                else                  coeff.emplace(key, value);
-                continue;
-            }
+    static void series_powi(const double *u, double *p, int K, int n)
+    {
+        constexpr int N = MAX_TAYLOR_ORDER + 1;
+        double base[N], tmp[N];
+        bool invert = n < 0;
+        unsigned m = invert ? -static_cast<unsigned>(n) : static_cast<unsigned>(n);
 
-            if (std::regex_match(term, m, exp_re))
+        for (int k = 0; k < K; k++) { p[k] = (k == 0); base[k] = u[k]; }
+        while (m > 0)
+        {
+            if (m & 1)
             {
-                std::string sign   = m[1].str();
-                std::string digits = m[2].str();
-                std::string inner  = m[3].str();
-
-                float value = digits.empty() ? 1.0f : std::stof(digits);
-                if (sign == "-") value = -value;
-
-                double a = 0.0, c = 0.0;
-                int n = 0;
-                if (!parse_exp_arg(inner, a, n, c))
-                {
-                    std::cerr << "[Function::extract_expression] Invalid exponent in e^(...): \""
-                              << term << "\"\n";
-                    continue;
-                }
-
-                std::string key = "exp(" + inner + ")";
-                if (coeff.count(key)) coeff[key] += value;
-                else                  coeff.emplace(key, value);
-                continue;
+                series_mul(p, base, tmp, K);
+                std::copy(tmp, tmp + K, p);
             }
-
-            if (std::regex_match(term, m, poly_re))
+            m >>= 1;
+            if (m > 0)
             {
-                std::string sign    = m[1].str();
-                std::string digits  = m[2].str();
-                bool        has_x   = !m[3].str().empty();
-                std::string exp_str = m[4].str();
-
-                if (!has_x && digits.empty()) continue; 
-
-                float value = digits.empty() ? 1.0f : std::stof(digits);
-                if (sign == "-") value = -value;
-
-                int degree = has_x ? (exp_str.empty() ? 1 : std::stoi(exp_str)) : 0;
-                std::string key = "x^" + std::to_string(degree);
-
-                if (coeff.count(key)) coeff[key] += value;
-                else                  coeff.emplace(key, value);
-                continue;
+                series_mul(base, base, tmp, K);
+                std::copy(tmp, tmp + K, base);
             }
-
-            std::cerr << "[Function::extract_expression] Unrecognised term: \""
-                      << term << "\"\n";
+        }
+        if (invert)
+        {
+            double one[N] = {1.0};
+            series_div(one, p, tmp, K);
+            std::copy(tmp, tmp + K, p);
         }
     }
 
+    // -----------------------------------------------------------------
+    //  Funciones elementales sobre intervalos. Las monótonas se evalúan
+    //  en los extremos; sin y cos revisan si [lo, hi] contiene un máximo
+    //  o un mínimo (π/2 + 2kπ, -π/2 + 2kπ para sin; 2kπ, π + 2kπ para
+    //  cos), y tan si contiene un polo π/2 + kπ.
+    // -----------------------------------------------------------------
+
+    static constexpr double PI = 3.14159265358979323846;
 
-    void Function::print() const
+    // ¿Hay algún punto phase + k*period dentro de [lo, hi]? El margen
+    // relativo hace la prueba conservadora frente al redondeo de k*period.
+    static bool hits_lattice(Interval a, double phase, double period)
     {
-        std::cout << "f(x) =";
-        bool first = true;
-        for (const auto &[key, coef] : coeff)
-        {
-            std::string prefix;
-            if (first) { prefix = " "; first = false; }
-            else        prefix = (coef >= 0) ? " + " : " - ";
-            std::cout << prefix;
+        double k = std::ceil((a.lo - phase) / period - 1e-12);
+        double t = phase + k * period;
+        return t <= a.hi + 1e-12 * (1.0 + std::abs(t));
+    }
 
-            float display = (coef < 0 && prefix != " ") ? -coef : coef;
-            if (prefix == " " && coef < 0) { std::cout << "-"; display = -coef; }
+    Interval sin(Interval a)
+    {
+        if (!(a.width() < 2.0 * PI)) return {-1.0, 1.0};
+        double s1 = std::sin(a.lo), s2 = std::sin(a.hi);
+        Interval r = outward(std::min(s1, s2), std::max(s1, s2));
+        if (hits_lattice(a,  PI / 2.0, 2.0 * PI)) r.hi = 1.0;
+        if (hits_lattice(a, -PI / 2.0, 2.0 * PI)) r.lo = -1.0;
+        return {std::max(r.lo, -1.0), std::min(r.hi, 1.0)};
+    }
 
-            if (std::fabs(display - 1.0f) > 1e-6f || key == "x^0")
-                std::cout << display;
+    Interval cos(Interval a)
+    {
+        if (!(a.width() < 2.0 * PI)) return {-1.0, 1.0};
+        double c1 = std::cos(a.lo), c2 = std::cos(a.hi);
+        Interval r = outward(std::min(c1, c2), std::max(c1, c2));
+        if (hits_lattice(a, 0.0, 2.0 * PI)) r.hi = 1.0;
+        if (hits_lattice(a, PI,  2.0 * PI)) r.lo = -1.0;
+        return {std::max(r.lo, -1.0), std::min(r.hi, 1.0)};
+    }
 
-            if (key != "x^0") std::cout << key;
-        }
-        std::cout << "\n";
+    Interval tan(Interval a)
+    {
+        if (!(a.width() < PI) || hits_lattice(a, PI / 2.0, PI)) return {-INFINITY, INFINITY};
+        return outward(std::tan(a.lo), std::tan(a.hi));
     }
 
- 
-    // =====================================================================
-    //  Matrix class implementation
-    // =====================================================================
+    Interval exp(Interval a)
+    {
+        return {std::max(0.0, std::nextafter(std::exp(a.lo), -INFINITY)), std::nextafter(std::exp(a.hi), INFINITY)};
+    }
 
-    Matrix::Matrix() : rows(0), columns(0) {}
+    // Fuera del dominio (x <= 0) el extremo inferior se va a -inf
+    Interval log(Interval a)
+    {
+        if (a.hi <= 0.0) return {NAN, NAN};
+        double lo = a.lo > 0.0 ? std::log(a.lo) : -INFINITY;
+        return outward(lo, std::log(a.hi));
+    }
 
-    Matrix::Matrix(const std::string& filename) : rows(0), columns(0)
+    Interval sqrt(Interval a)
     {
-        read_from_file(filename);
+        if (a.hi < 0.0) return {NAN, NAN};
+        double lo = a.lo > 0.0 ? std::sqrt(a.lo) : 0.0;
+        return {std::max(0.0, std::nextafter(lo, -INFINITY)), std::nextafter(std::sqrt(a.hi), INFINITY)};
     }
 
-    Matrix::Matrix(int rows, int columns)
-        : data(rows, std::vector<double>(columns, 0.0)),
-          rows(rows), columns(columns) {}
+    // x^n exacto en rango: las potencias pares de un intervalo que cruza 0
+    // empiezan en 0 (x*x daría [lo*hi, ...], un encierro más ancho)
+    Interval pow(Interval a, int n)
+    {
+        if (n == 0) return {1.0, 1.0};
+        if (n < 0) return Interval{1.0} / pow(a, -n);
+        double l = ipow(a.lo, n), h = ipow(a.hi, n);
+        Interval r;
+        if (n % 2 == 1)           r = {l, h};
+        else if (a.lo >= 0.0)     r = {l, h};
+        else if (a.hi <= 0.0)     r = {h, l};
+        else                      r = {0.0, std::max(l, h)};
+        // ipow hace hasta 2*log2(n) productos redondeados: se ensancha en proporción
+        int ulps = 2 * std::bit_width(static_cast<unsigned>(n));
+        for (int i = 0; i < ulps; i++) r = outward(r.lo, r.hi);
+        if (n % 2 == 0 && r.lo < 0.0) r.lo = 0.0;
+        return r;
+    }
 
-    Matrix::Matrix(const std::vector<std::vector<double>>& data)
-        : data(data),
-          rows(static_cast<int>(data.size())),
-          columns(data.empty() ? 0 : static_cast<int>(data[0].size())) {}
+    // -----------------------------------------------------------------
+    //  Evaluación de la cinta. T es double, Dual o Interval; lift
+    //  convierte una constante al tipo de trabajo.
+    // -----------------------------------------------------------------
 
-    void Matrix::set(int row, int column, double value)
+    static inline double   lift(double v, double)   { return v; }
+    static inline Dual     lift(double v, Dual)     { return {v, 0.0}; }
+    static inline Interval lift(double v, Interval) { return Interval{v}; }
+
+    template <typename T>
+    static T powi(T x, int n)
     {
-        if (row < 0 || row >= rows || column < 0 || column >= columns)
+        bool invert = n < 0;
+        unsigned m = invert ? -static_cast<unsigned>(n) : static_cast<unsigned>(n);
+        T result = lift(1.0, x);
+        while (m > 0)
         {
-            std::cerr << "[Matrix::set] Index out of bounds ("
-                      << row << ", " << column << ")\n";
-            return;
+            if (m & 1) result = result * x;
+            m >>= 1;
+            if (m > 0) x = x * x;
         }
-        data[row][column] = value;
+        return invert ? lift(1.0, x) / result : result;
     }
 
-    double Matrix::get(int row, int column) const
+    // Para intervalos x^n por productos sobreestima (x*x con 0 adentro)
+    static inline Interval powi(Interval x, int n) { return pow(x, n); }
+
+    static inline void sincos_pair(double a, double &s, double &c)
     {
-        if (row < 0 || row >= rows || column < 0 || column >= columns)
-        {
-            std::cerr << "[Matrix::get] Index out of bounds ("
-                      << row << ", " << column << ")\n";
-            return 0.0;
-        }
-        return data[row][column];
+        sincos_value(a, s, c);
     }
 
-    int Matrix::getRows() const { return rows; }
-    int Matrix::getCols() const { return columns; }
-
-    void Matrix::print() const
+    static inline void sincos_pair(Dual a, Dual &s, Dual &c)
     {
-        for (int i = 0; i < rows; i++)
-        {
-            std::cout << "| ";
-            for (int j = 0; j < columns; j++)
-                std::cout << std::setw(10) << std::fixed
-                          << std::setprecision(4) << data[i][j] << " ";
-            std::cout << "|\n";
-        }
+        double sv, cv;
+        sincos_value(a.value, sv, cv);
+        s = {sv,  cv * a.derivative};
+        c = {cv, -sv * a.derivative};
     }
 
-    void Matrix::add(const Matrix& other)
+    static inline void sincos_pair(Interval a, Interval &s, Interval &c)
     {
-        if (rows != other.rows || columns != other.columns)
-        {
-            std::cerr << "[Matrix::add] Dimension mismatch\n";
-            return;
-        }
-        for (int i = 0; i < rows; i++)
-            for (int j = 0; j < columns; j++)
-                data[i][j] += other.data[i][j];
+        s = sin(a);
+        c = cos(a);
     }
 
-    void Matrix::subtract(const Matrix& other)
+    template <typename T>
+    static T run_tape(const std::vector<ExprNode> &nodes, T x)
     {
-        if (rows != other.rows || columns != other.columns)
+        using std::sin; using std::cos; using std::tan;
+        using std::exp; using std::log; using std::sqrt;
+
+        thread_local std::vector<T> slot;
+        slot.resize(nodes.size());
+
+        for (std::size_t i = 0; i < nodes.size(); i++)
         {
-            std::cerr << "[Matrix::subtract] Dimension mismatch\n";
-            return;
+            const ExprNode &nd = nodes[i];
+            const T &a = slot[nd.lhs < 0 ? i : nd.lhs];
+            const T &b = slot[nd.rhs < 0 ? i : nd.rhs];
+            T r{};
+            switch (nd.op)
+            {
+                case ExprOp::Const:  r = lift(nd.value, x);                      break;
+                case ExprOp::X:      r = x;                                      break;
+                case ExprOp::Add:    r = a + b;                                  break;
+                case ExprOp::Sub:    r = a - b;                                  break;
+                case ExprOp::Mul:    r = a * b;                                  break;
+                case ExprOp::Div:    r = a / b;                                  break;
+                case ExprOp::Neg:    r = -a;                                     break;
+                case ExprOp::PowInt: r = powi(a, static_cast<int>(nd.value));   break;
+                case ExprOp::Sin:
+                case ExprOp::Cos:
+                    if (nd.pair < 0)
+                        r = (nd.op == ExprOp::Sin) ? sin(a) : cos(a);
+                    else if (nd.pair < static_cast<int>(i))
+                        r = slot[i];    // ya lo calculó su pareja
+                    else if (nd.op == ExprOp::Sin)
+                        sincos_pair(a, r, slot[nd.pair]);
+                    else
+                        sincos_pair(a, slot[nd.pair], r);
+                    break;
+                case ExprOp::Tan:    r = tan(a);                                 break;
+                case ExprOp::Exp:    r = exp(a);                                 break;
+                case ExprOp::Ln:     r = log(a);                                 break;
+                case ExprOp::Sqrt:   r = sqrt(a);                                break;
+                case ExprOp::Pow:
+                    if constexpr (std::is_same_v<T, double>) r = std::pow(a, b);
+                    else                                     r = exp(b * log(a));
+                    break;
+            }
+            slot[i] = r;
         }
-        for (int i = 0; i < rows; i++)
-            for (int j = 0; j < columns; j++)
-                data[i][j] -= other.data[i][j];
+        return slot.back();
     }
 
-    void Matrix::multiply(const Matrix& other)
+    // y[k] += cinta(x[k]) para un bloque de hasta EVAL_BLOCK puntos, nodo por nodo
+    static void run_tape_block(const std::vector<ExprNode> &nodes, const double *x, double *y, std::size_t len)
     {
-        if (columns != other.rows)
+        thread_local std::vector<double> slot;
+        slot.resize(nodes.size() * EVAL_BLOCK);
+        double scratch[EVAL_BLOCK];
+
+        for (std::size_t i = 0; i < nodes.size(); i++)
         {
-            std::cerr << "[Matrix::multiply] Incompatible dimensions ("
+            const ExprNode &nd = nodes[i];
+            double       *r = slot.data() + i * EVAL_BLOCK;
+            const double *a = nd.lhs < 0 ? nullptr : slot.data() + nd.lhs * EVAL_BLOCK;
+            const double *b = nd.rhs < 0 ? nullptr : slot.data() + nd.rhs * EVAL_BLOCK;
+            switch (nd.op)
+            {
+                case ExprOp::Const: for (std::size_t k = 0; k < len; k++) r[k] = nd.value;           break;
+                case ExprOp::X:     for (std::size_t k = 0; k < len; k++) r[k] = x[k];               break;
+                case ExprOp::Add:   for (std::size_t k = 0; k < len; k++) r[k] = a[k] + b[k];        break;
+                case ExprOp::Sub:   for (std::size_t k = 0; k < len; k++) r[k] = a[k] - b[k];        break;
+                case ExprOp::Mul:   for (std::size_t k = 0; k < len; k++) r[k] = a[k] * b[k];        break;
+                case ExprOp::Div:   for (std::size_t k = 0; k < len; k++) r[k] = a[k] / b[k];        break;
+                case ExprOp::Neg:   for (std::size_t k = 0; k < len; k++) r[k] = -a[k];              break;
+                case ExprOp::Sin:
+                case ExprOp::Cos:
+                {
+                    if (nd.pair >= 0 && nd.pair < static_cast<int>(i)) break;
+                    const bool is_sin = nd.op == ExprOp::Sin;
+                    if (nd.pair < 0)
+                    {
+                        if (is_sin) for (std::size_t k = 0; k < len; k++) r[k] = std::sin(a[k]);
+                        else        for (std::size_t k = 0; k < len; k++) r[k] = std::cos(a[k]);
+                        break;
+                    }
+                    double *s = is_sin ? r : slot.data() + nd.pair * EVAL_BLOCK;
+                    double *c = is_sin ? slot.data() + nd.pair * EVAL_BLOCK : r;
+                    for (std::size_t k = 0; k < len; k++)
+                    {
+                        s[k] = std::sin(a[k]);
+                        c[k] = std::cos(a[k]);
+                    }
+                    break;
+                }
+                case ExprOp::Tan:   for (std::size_t k = 0; k < len; k++) r[k] = std::tan(a[k]);     break;
+                case ExprOp::Exp:   for (std::size_t k = 0; k < len; k++) r[k] = std::exp(a[k]);     break;
+                case ExprOp::Ln:    for (std::size_t k = 0; k < len; k++) r[k] = std::log(a[k]);     break;
+                case ExprOp::Sqrt:  for (std::size_t k = 0; k < len; k++) r[k] = std::sqrt(a[k]);    break;
+                case ExprOp::Pow:   for (std::size_t k = 0; k < len; k++) r[k] = std::pow(a[k], b[k]); break;
+                case ExprOp::PowInt:
+                {
+                    int n = static_cast<int>(nd.value);
+                    power_block(a, r, scratch, len, n < 0 ? -n : n);
+                    if (n < 0)
+                        for (std::size_t k = 0; k < len; k++) r[k] = 1.0 / r[k];
+                    break;
+                }
+            }
+        }
+
+        const double *root = slot.data() + (nodes.size() - 1) * EVAL_BLOCK;
+        for (std::size_t k = 0; k < len; k++) y[k] += root[k];
+    }
+
+    // total[k] += coeficiente k de la serie de Taylor de la cinta en x
+    static void run_tape_taylor(const std::vector<ExprNode> &nodes, double x, int K, double *total)
+    {
+        constexpr int N = MAX_TAYLOR_ORDER + 1;
+        thread_local std::vector<double> slot;
+        slot.resize(nodes.size() * N);
+        double tmp[N], tmp2[N];
+
+        for (std::size_t i = 0; i < nodes.size(); i++)
+        {
+            const ExprNode &nd = nodes[i];
+            double       *r = slot.data() + i * N;
+            const double *a = nd.lhs < 0 ? nullptr : slot.data() + nd.lhs * N;
+            const double *b = nd.rhs < 0 ? nullptr : slot.data() + nd.rhs * N;
+            switch (nd.op)
+            {
+                case ExprOp::Const:
+                    for (int k = 0; k < K; k++) r[k] = (k == 0) ? nd.value : 0.0;
+                    break;
+                case ExprOp::X:
+                    for (int k = 0; k < K; k++) r[k] = (k == 0) ? x : (k == 1) ? 1.0 : 0.0;
+                    break;
+                case ExprOp::Add: for (int k = 0; k < K; k++) r[k] = a[k] + b[k]; break;
+                case ExprOp::Sub: for (int k = 0; k < K; k++) r[k] = a[k] - b[k]; break;
+                case ExprOp::Neg: for (int k = 0; k < K; k++) r[k] = -a[k];       break;
+                case ExprOp::Mul:    series_mul(a, b, r, K);                      break;
+                case ExprOp::Div:    series_div(a, b, r, K);                      break;
+                case ExprOp::PowInt: series_powi(a, r, K, static_cast<int>(nd.value)); break;
+                case ExprOp::Sin:
+                case ExprOp::Cos:
+                {
+                    if (nd.pair >= 0 && nd.pair < static_cast<int>(i)) break;
+                    double *other = nd.pair < 0 ? tmp : slot.data() + nd.pair * N;
+                    if (nd.op == ExprOp::Sin) series_sincos(a, r, other, K);
+                    else                      series_sincos(a, other, r, K);
+                    break;
+                }
+                case ExprOp::Tan:
+                    series_sincos(a, tmp, tmp2, K);
+                    series_div(tmp, tmp2, r, K);
+                    break;
+                case ExprOp::Exp:    series_exp(a, r, K);                         break;
+                case ExprOp::Ln:     series_ln(a, r, K);                          break;
+                case ExprOp::Sqrt:   series_sqrt(a, r, K);                        break;
+                case ExprOp::Pow:    // a^b = exp(b ln a)
+                    series_ln(a, tmp, K);
+                    series_mul(b, tmp, tmp2, K);
+                    series_exp(tmp2, r, K);
+                    break;
+            }
+        }
+
+        const double *root = slot.data() + (nodes.size() - 1) * N;
+        for (int k = 0; k < K; k++) total[k] += root[k];
+    }
+
+    // -----------------------------------------------------------------
+    //  Traducción del árbol a llaves de coeff
+    // -----------------------------------------------------------------
+
+    // Sumandos de primer nivel con su signo: a - (b + c) -> (a,+1) (b,-1) (c,-1)
+    static void collect_terms(const std::vector<ExprNode> &nodes, int idx, double sign,
+                              std::vector<std::pair<int, double>> &terms)
+    {
+        const ExprNode &nd = nodes[idx];
+        switch (nd.op)
+        {
+            case ExprOp::Add:
+                collect_terms(nodes, nd.lhs, sign, terms);
+                collect_terms(nodes, nd.rhs, sign, terms);
+                break;
+            case ExprOp::Sub:
+                collect_terms(nodes, nd.lhs, sign, terms);
+                collect_terms(nodes, nd.rhs, -sign, terms);
+                break;
+            case ExprOp::Neg:
+                collect_terms(nodes, nd.lhs, -sign, terms);
+                break;
+            default:
+                terms.emplace_back(idx, sign);
+        }
+    }
+
+    // Aplica un operador (que no sea hoja) a operandos constantes
+    static double apply_op(const ExprNode &nd, double a, double b)
+    {
+        switch (nd.op)
+        {
+            case ExprOp::Add:    return a + b;
+            case ExprOp::Sub:    return a - b;
+            case ExprOp::Mul:    return a * b;
+            case ExprOp::Div:    return a / b;
+            case ExprOp::Neg:    return -a;
+            case ExprOp::PowInt: return powi(a, static_cast<int>(nd.value));
+            case ExprOp::Pow:    return std::pow(a, b);
+            case ExprOp::Sin:    return std::sin(a);
+            case ExprOp::Cos:    return std::cos(a);
+            case ExprOp::Tan:    return std::tan(a);
+            case ExprOp::Exp:    return std::exp(a);
+            case ExprOp::Ln:     return std::log(a);
+            case ExprOp::Sqrt:   return std::sqrt(a);
+            default:             return nd.value;
+        }
+    }
+
+    // Valor de un subárbol que no depende de x
+    static bool constant_value(const std::vector<ExprNode> &nodes, int idx, double &value)
+    {
+        const ExprNode &nd = nodes[idx];
+        double a = 0.0, b = 0.0;
+        if (nd.op == ExprOp::X) return false;
+        if (nd.op == ExprOp::Const) { value = nd.value; return true; }
+        if (nd.lhs >= 0 && !constant_value(nodes, nd.lhs, a)) return false;
+        if (nd.rhs >= 0 && !constant_value(nodes, nd.rhs, b)) return false;
+        value = apply_op(nd, a, b);
+        return true;
+    }
+
+    // idx = factor * núcleo. Multiplica factor y retorna el núcleo (-1 si todo es constante).
+    // e^(c) se conserva como núcleo para que siga teniendo su llave "exp(c)".
+    static int split_constant_factor(const std::vector<ExprNode> &nodes, int idx, double &factor)
+    {
+        const ExprNode &nd = nodes[idx];
+        if (nd.op == ExprOp::Exp) return idx;
+
+        double value;
+        if (constant_value(nodes, idx, value)) { factor *= value; return -1; }
+
+        if (nd.op == ExprOp::Neg)
+        {
+            factor = -factor;
+            return split_constant_factor(nodes, nd.lhs, factor);
+        }
+        if (nd.op == ExprOp::Mul)
+        {
+            if (constant_value(nodes, nd.lhs, value))
+            {
+                factor *= value;
+                return split_constant_factor(nodes, nd.rhs, factor);
+            }
+            if (constant_value(nodes, nd.rhs, value))
+            {
+                factor *= value;
+                return split_constant_factor(nodes, nd.lhs, factor);
+            }
+        }
+        if (nd.op == ExprOp::Div && constant_value(nodes, nd.rhs, value))
+        {
+            factor /= value;
+            return split_constant_factor(nodes, nd.lhs, factor);
+        }
+        return idx;
+    }
+
+    // x^N con N ≥ 0 entero
+    static bool monomial_degree(const std::vector<ExprNode> &nodes, int idx, int &degree)
+    {
+        const ExprNode &nd = nodes[idx];
+        if (nd.op == ExprOp::X) { degree = 1; return true; }
+        if (nd.op == ExprOp::PowInt && nd.value >= 0 && nodes[nd.lhs].op == ExprOp::X)
+        {
+            degree = static_cast<int>(nd.value);
+            return true;
+        }
+        return false;
+    }
+
+    // Decimal sin notación científica, como lo acepta parse_exp_arg
+    static bool format_plain(double value, std::string &text)
+    {
+        char buffer[32];
+        auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), std::abs(value),
+                                       std::chars_format::fixed);
+        if (ec != std::errc()) return false;
+        text.assign(buffer, end);
+        return true;
+    }
+
+    // Llave de exp(a x^n) o, con a = 0, de exp(c): "exp(2.5x)", "exp(-x^2)", "exp(4)"
+    static bool exp_key(double a, int n, double c, std::string &key)
+    {
+        const double shown = (a == 0.0) ? c : a;
+        std::string digits;
+        if (!format_plain(shown, digits)) return false;
+        std::string sign = shown < 0 ? "-" : "";
+
+        if (a == 0.0)
+            key = "exp(" + sign + digits + ")";
+        else
+            key = "exp(" + sign + (std::abs(a) == 1.0 ? "" : digits) + "x"
+                + (n == 1 ? "" : "^" + std::to_string(n)) + ")";
+        return true;
+    }
+
+    // Llave de coeff para el núcleo de un sumando; false si no tiene forma de llave
+    static bool legacy_key(const std::vector<ExprNode> &nodes, int core, std::string &key)
+    {
+        const ExprNode &nd = nodes[core];
+        int degree;
+
+        if (monomial_degree(nodes, core, degree))
+        {
+            key = "x^" + std::to_string(degree);
+            return true;
+        }
+
+        if ((nd.op == ExprOp::Sin || nd.op == ExprOp::Cos || nd.op == ExprOp::Tan)
+            && monomial_degree(nodes, nd.lhs, degree))
+        {
+            const char *name = nd.op == ExprOp::Sin ? "sin" : nd.op == ExprOp::Cos ? "cos" : "tan";
+            key = std::string(name) + "(x^" + std::to_string(degree) + ")";
+            return true;
+        }
+
+        if (nd.op == ExprOp::Exp)
+        {
+            double a = 1.0;
+            int inner = split_constant_factor(nodes, nd.lhs, a);
+            if (inner < 0) return exp_key(0.0, 0, a, key);
+            if (a != 0.0 && monomial_degree(nodes, inner, degree) && degree >= 1)
+                return exp_key(a, degree, 0.0, key);
+        }
+        return false;
+    }
+
+    // Copia el subárbol idx al final de dst y retorna su nueva raíz
+    static int copy_subtree(const std::vector<ExprNode> &src, int idx, std::vector<ExprNode> &dst)
+    {
+        ExprNode nd = src[idx];
+        if (nd.lhs >= 0) nd.lhs = copy_subtree(src, nd.lhs, dst);
+        if (nd.rhs >= 0) nd.rhs = copy_subtree(src, nd.rhs, dst);
+        dst.push_back(nd);
+        return static_cast<int>(dst.size()) - 1;
+    }
+
+    // -----------------------------------------------------------------
+    //  simplify_expression
+    //
+    //  Pasada de optimización sobre la cinta residual, antes de evaluar:
+    //    • plegado de constantes e identidades (a+0, a*1, a*0, a^1, --a,
+    //      a*a -> a^2, (a^m)^n -> a^(mn))
+    //    • hash-consing: subárboles idénticos se comparten, p. ej. el x^2
+    //      de sin(x^2) y cos(x^2) se calcula una sola vez
+    //    • suma de términos semejantes: 2sin(2x) - 5sin(2x) -> -3sin(2x)
+    //    • eliminación de nodos muertos (la raíz queda al final)
+    //    • sin y cos del mismo argumento se enlazan por `pair` para que
+    //      los evaluadores hagan un solo sincos
+    // -----------------------------------------------------------------
+
+    class TapeBuilder
+    {
+    public:
+        std::vector<ExprNode> out;
+
+        int constant(double value) { return intern({ExprOp::Const, -1, -1, value}); }
+
+        int intern(ExprNode nd)
+        {
+            nd.pair = -1;
+            // e^(c) no se pliega: conserva su llave "exp(c)" al traducir a coeff
+            if (nd.op != ExprOp::Const && nd.op != ExprOp::X && nd.op != ExprOp::Exp && is_const(nd.lhs)
+                && (nd.rhs < 0 || is_const(nd.rhs)))
+                return constant(apply_op(nd, out[nd.lhs].value, nd.rhs < 0 ? 0.0 : out[nd.rhs].value));
+
+            switch (nd.op)
+            {
+                case ExprOp::Add:
+                    if (is_const(nd.lhs, 0.0)) return nd.rhs;
+                    if (is_const(nd.rhs, 0.0)) return nd.lhs;
+                    if (nd.lhs > nd.rhs) std::swap(nd.lhs, nd.rhs);
+                    break;
+                case ExprOp::Sub:
+                    if (is_const(nd.rhs, 0.0)) return nd.lhs;
+                    if (is_const(nd.lhs, 0.0)) return intern({ExprOp::Neg, nd.rhs});
+                    if (nd.lhs == nd.rhs)      return constant(0.0);
+                    break;
+                case ExprOp::Mul:
+                    if (is_const(nd.lhs, 0.0) || is_const(nd.rhs, 0.0)) return constant(0.0);
+                    if (is_const(nd.lhs, 1.0))  return nd.rhs;
+                    if (is_const(nd.rhs, 1.0))  return nd.lhs;
+                    if (is_const(nd.lhs, -1.0)) return intern({ExprOp::Neg, nd.rhs});
+                    if (is_const(nd.rhs, -1.0)) return intern({ExprOp::Neg, nd.lhs});
+                    if (nd.lhs == nd.rhs)       return intern({ExprOp::PowInt, nd.lhs, -1, 2.0});
+                    if (nd.lhs > nd.rhs) std::swap(nd.lhs, nd.rhs);
+                    break;
+                case ExprOp::Div:
+                    if (is_const(nd.rhs, 1.0)) return nd.lhs;
+                    break;
+                case ExprOp::Neg:
+                    if (out[nd.lhs].op == ExprOp::Neg) return out[nd.lhs].lhs;
+                    break;
+                case ExprOp::PowInt:
+                    if (nd.value == 1.0) return nd.lhs;
+                    if (nd.value == 0.0) return constant(1.0);
+                    // (a^m)^n -> a^(mn) solo si mn sigue siendo un exponente int válido
+                    if (out[nd.lhs].op == ExprOp::PowInt && integer_exponent(nd.value * out[nd.lhs].value))
+                        return intern({ExprOp::PowInt, out[nd.lhs].lhs, -1, nd.value * out[nd.lhs].value});
+                    break;
+                default:
+                    break;
+            }
+
+            auto key = std::make_tuple(static_cast<int>(nd.op), nd.lhs, nd.rhs,
+                                       std::bit_cast<std::uint64_t>(nd.value));
+            auto [it, inserted] = seen.try_emplace(key, static_cast<int>(out.size()));
+            if (inserted) out.push_back(nd);
+            return it->second;
+        }
+
+    private:
+        std::map<std::tuple<int, int, int, std::uint64_t>, int> seen;
+
+        bool is_const(int idx) const { return idx >= 0 && out[idx].op == ExprOp::Const; }
+        bool is_const(int idx, double value) const { return is_const(idx) && out[idx].value == value; }
+    };
+
+    static void simplify_expression(std::vector<ExprNode> &nodes)
+    {
+        if (nodes.empty()) return;
+
+        // 1. Plegado, identidades y hash-consing
+        TapeBuilder builder;
+        std::vector<int> remap(nodes.size());
+        for (std::size_t i = 0; i < nodes.size(); i++)
+        {
+            ExprNode nd = nodes[i];
+            if (nd.lhs >= 0) nd.lhs = remap[nd.lhs];
+            if (nd.rhs >= 0) nd.rhs = remap[nd.rhs];
+            remap[i] = builder.intern(nd);
+        }
+        std::vector<ExprNode> &out = builder.out;
+
+        // 2. Términos semejantes: mismo núcleo compartido => se suman los factores
+        std::vector<std::pair<int, double>> terms, groups;
+        collect_terms(out, remap.back(), 1.0, terms);
+        double constant = 0.0;
+        for (const auto &[node, sign] : terms)
+        {
+            double factor = sign;
+            int core = split_constant_factor(out, node, factor);
+            if (core < 0) { constant += factor; continue; }
+            auto it = std::find_if(groups.begin(), groups.end(),
+                                   [core](const auto &g) { return g.first == core; });
+            if (it != groups.end()) it->second += factor;
+            else                    groups.emplace_back(core, factor);
+        }
+        if (constant != 0.0) groups.emplace_back(builder.constant(1.0), constant);
+
+        int root = -1;
+        for (const auto &[core, factor] : groups)
+        {
+            if (factor == 0.0) continue;
+            double magnitude = (root >= 0) ? std::abs(factor) : factor;
+            int term = builder.intern({ExprOp::Mul, builder.constant(magnitude), core});
+            root = (root < 0) ? term
+                 : builder.intern({factor < 0 ? ExprOp::Sub : ExprOp::Add, root, term});
+        }
+        if (root < 0 || (out[root].op == ExprOp::Const && out[root].value == 0.0))
+        {
+            nodes.clear();
+            return;
+        }
+
+        // 3. Nodos vivos (descendientes de la raíz), en el mismo orden
+        std::vector<char> live(root + 1, 0);
+        live[root] = 1;
+        for (int i = root; i >= 0; i--)
+        {
+            if (!live[i]) continue;
+            if (out[i].lhs >= 0) live[out[i].lhs] = 1;
+            if (out[i].rhs >= 0) live[out[i].rhs] = 1;
+        }
+        nodes.clear();
+        remap.assign(root + 1, -1);
+        for (int i = 0; i <= root; i++)
+        {
+            if (!live[i]) continue;
+            ExprNode nd = out[i];
+            if (nd.lhs >= 0) nd.lhs = remap[nd.lhs];
+            if (nd.rhs >= 0) nd.rhs = remap[nd.rhs];
+            remap[i] = static_cast<int>(nodes.size());
+            nodes.push_back(nd);
+        }
+
+        // 4. Parejas sin/cos del mismo argumento
+        std::map<int, int> sin_of, cos_of;
+        for (int i = 0; i < static_cast<int>(nodes.size()); i++)
+        {
+            if (nodes[i].op == ExprOp::Sin) sin_of[nodes[i].lhs] = i;
+            if (nodes[i].op == ExprOp::Cos) cos_of[nodes[i].lhs] = i;
+        }
+        for (const auto &[arg, s] : sin_of)
+        {
+            auto it = cos_of.find(arg);
+            if (it == cos_of.end()) continue;
+            nodes[s].pair = it->second;
+            nodes[it->second].pair = s;
+        }
+    }
+
+    // -----------------------------------------------------------------
+    //  Impresión con paréntesis mínimos según precedencia
+    // -----------------------------------------------------------------
+
+    static int precedence(ExprOp op)
+    {
+        switch (op)
+        {
+            case ExprOp::Add: case ExprOp::Sub: return 1;
+            case ExprOp::Mul: case ExprOp::Div: return 2;
+            case ExprOp::Neg:                   return 3;
+            case ExprOp::PowInt: case ExprOp::Pow: return 4;
+            default:                            return 5;
+        }
+    }
+
+    static std::string expression_to_string(const std::vector<ExprNode> &nodes, int idx)
+    {
+        const ExprNode &nd = nodes[idx];
+        auto child = [&](int c, int min_prec)
+        {
+            std::string text = expression_to_string(nodes, c);
+            if (precedence(nodes[c].op) < min_prec ||
+                (nodes[c].op == ExprOp::Const && nodes[c].value < 0 && min_prec > 1))
+                return "(" + text + ")";
+            return text;
+        };
+        auto call = [&](const char *name) { return std::string(name) + "(" + expression_to_string(nodes, nd.lhs) + ")"; };
+
+        switch (nd.op)
+        {
+            case ExprOp::Const:
+            {
+                std::ostringstream os;
+                os << nd.value;
+                return os.str();
+            }
+            case ExprOp::X:      return "x";
+            case ExprOp::Add:    return child(nd.lhs, 1) + " + " + child(nd.rhs, 1);
+            case ExprOp::Sub:    return child(nd.lhs, 1) + " - " + child(nd.rhs, 2);
+            case ExprOp::Mul:
+                if (nodes[nd.rhs].op == ExprOp::Const && nodes[nd.lhs].op != ExprOp::Const)
+                    return child(nd.rhs, 2) + "*" + child(nd.lhs, 2);
+                return child(nd.lhs, 2) + "*" + child(nd.rhs, 2);
+            case ExprOp::Div:    return child(nd.lhs, 2) + "/" + child(nd.rhs, 3);
+            case ExprOp::Neg:    return "-" + child(nd.lhs, 3);
+            case ExprOp::PowInt:
+            {
+                std::ostringstream os;
+                os << nd.value;
+                return child(nd.lhs, 5) + "^" + (nd.value < 0 ? "(" + os.str() + ")" : os.str());
+            }
+            case ExprOp::Pow:    return child(nd.lhs, 5) + "^" + child(nd.rhs, 5);
+            case ExprOp::Sin:    return call("sin");
+            case ExprOp::Cos:    return call("cos");
+            case ExprOp::Tan:    return call("tan");
+            case ExprOp::Exp:    return call("exp");
+            case ExprOp::Ln:     return call("ln");
+            case ExprOp::Sqrt:   return call("sqrt");
+        }
+        return "";
+    }
+
+    bool Function::valid_key(const std::string &key) const
+    {
+        Term term;
+        return lower_key(key, 0.0, term);
+    }
+
+    // -------------------------------------------------------------------------
+    //  lower_key
+    //
+    //  Traduce una llave de `coeff` a su término compilado, sin expresiones
+    //  regulares; se ejecuta solo cuando cambian los términos
+    //  (extract_expression, add, update).
+    //
+    //    "x^N"          ->  Power  (scale = 1, offset = 0)
+    //    "sin(x^N)"     ->  Sin    (idem para cos / tan)
+    //    "exp(a x^n)"   ->  Exp    (scale = a, offset = 0)
+    //    "exp(c)"       ->  Exp    (scale = 0, offset = c)
+    // -------------------------------------------------------------------------
+
+    static bool parse_degree(std::string_view text, int &n)
+    {
+        if (text.empty() || !std::isdigit(static_cast<unsigned char>(text[0]))) return false;
+        auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), n);
+        return ec == std::errc() && end == text.data() + text.size() && n >= 0;
+    }
+
+    bool Function::lower_key(const std::string &key, double coef, Term &term) const
+    {
+        term.coefficient = coef;
+        term.scale       = 1.0;
+        term.offset      = 0.0;
+
+        std::string_view k = key;
+        if (k.starts_with("x^"))
+        {
+            term.kind = TermKind::Power;
+            return parse_degree(k.substr(2), term.exponent);
+        }
+
+        if (!k.ends_with(")")) return false;
+
+        if (k.starts_with("sin(x^") || k.starts_with("cos(x^") || k.starts_with("tan(x^"))
+        {
+            if      (k[0] == 's') term.kind = TermKind::Sin;
+            else if (k[0] == 'c') term.kind = TermKind::Cos;
+            else                  term.kind = TermKind::Tan;
+            return parse_degree(k.substr(6, k.size() - 7), term.exponent);
+        }
+
+        if (k.starts_with("exp("))
+        {
+            double a = 0.0, c = 0.0;
+            int n = 0;
+            if (!parse_exp_arg(k.substr(4, k.size() - 5), a, n, c)) return false;
+            term.kind     = TermKind::Exp;
+            term.exponent = n;
+            term.scale    = a;
+            term.offset   = (a == 0.0) ? c : 0.0;
+            return true;
+        }
+
+        return false;
+    }
+
+    // Llave escrita a mano (get, contains, update, add) en la forma en que la
+    // genera extract_expression: el texto de e^(...) ya no se guarda literal,
+    // así que "exp(2.50x)" o "exp(+2.5x)" pasan a "exp(2.5x)" y "sin(x^02)" a
+    // "sin(x^2)". Lo que no es una llave se devuelve igual (valid_key lo rechaza).
+    static std::string normalize_key(const std::string &key)
+    {
+        std::string_view k = key;
+        int n = 0;
+        if (k.starts_with("x^"))
+            return parse_degree(k.substr(2), n) ? "x^" + std::to_string(n) : key;
+
+        if (!k.ends_with(")")) return key;
+
+        if (k.starts_with("sin(x^") || k.starts_with("cos(x^") || k.starts_with("tan(x^"))
+            return parse_degree(k.substr(6, k.size() - 7), n)
+                 ? std::string(k.substr(0, 6)) + std::to_string(n) + ")" : key;
+
+        double a = 0.0, c = 0.0;
+        std::string canonical;
+        if (k.starts_with("exp(") && parse_exp_arg(k.substr(4, k.size() - 5), a, n, c)
+            && exp_key(a, n, c, canonical))
+            return canonical;
+        return key;
+    }
+
+    void Function::compile()
+    {
+        program.clear();
+        program.reserve(coeff.size());
+        for (const auto &[key, coef] : coeff)
+        {
+            Term term;
+            if (lower_key(key, static_cast<double>(coef), term))
+                program.push_back(term);
+            else
+                std::cerr << "[Function::compile] Unknown key: \"" << key << "\"\n";
+        }
+
+        // Términos con el mismo argumento quedan contiguos: x^n se calcula una
+        // vez por exponente y sin/cos del mismo g(x) se fusionan en SinCos.
+        std::stable_sort(program.begin(), program.end(), [](const Term &a, const Term &b)
+        {
+            if (a.exponent != b.exponent) return a.exponent < b.exponent;
+            if (a.scale != b.scale)       return a.scale < b.scale;
+            if (a.offset != b.offset)     return a.offset < b.offset;
+            return a.kind < b.kind;
+        });
+        std::vector<Term> fused;
+        fused.reserve(program.size());
+        for (const Term &t : program)
+        {
+            if (t.kind == TermKind::Cos && !fused.empty() && fused.back().kind == TermKind::Sin
+                && fused.back().exponent == t.exponent && fused.back().scale == t.scale
+                && fused.back().offset == t.offset)
+            {
+                fused.back().kind = TermKind::SinCos;
+                fused.back().cos_coefficient = t.coefficient;
+                continue;
+            }
+            fused.push_back(t);
+        }
+        program.swap(fused);
+
+        // Camino rápido: polinomio puro -> vector denso evaluado con Horner
+        polynomial = expr.empty() && std::all_of(program.begin(), program.end(),
+            [](const Term &t) { return t.kind == TermKind::Power; });
+        poly.clear();
+        if (polynomial)
+        {
+            for (const Term &t : program)
+            {
+                if (static_cast<int>(poly.size()) <= t.exponent)
+                    poly.resize(t.exponent + 1, 0.0);
+                poly[t.exponent] += t.coefficient;
+            }
+        }
+    }
+
+    bool Function::is_polynomial() const { return polynomial; }
+
+    // Coeficientes densos (poly[k] acompaña a x^k); vacío si f no es polinomio
+    std::vector<double> Function::polynomial_coefficients() const
+    {
+        if (!polynomial) return {};
+        return poly;
+    }
+
+    Function::Function() {}
+
+    double Function::evaluate(double x) const
+    {
+        if (polynomial)
+        {
+            double p = 0.0;
+            for (std::size_t k = poly.size(); k-- > 0;)
+                p = p * x + poly[k];
+            return p;
+        }
+
+        double result = 0.0;
+        int last_exponent = -1;
+        double xn = 0.0;
+        for (const Term &t : program)
+        {
+            if (t.exponent != last_exponent)
+            {
+                xn = ipow(x, t.exponent);
+                last_exponent = t.exponent;
+            }
+            double gx = t.scale * xn + t.offset;
+            switch (t.kind)
+            {
+                case TermKind::Power: result += t.coefficient * gx;           break;
+                case TermKind::Sin:   result += t.coefficient * std::sin(gx); break;
+                case TermKind::Cos:   result += t.coefficient * std::cos(gx); break;
+                case TermKind::Tan:   result += t.coefficient * std::tan(gx); break;
+                case TermKind::Exp:   result += t.coefficient * std::exp(gx); break;
+                case TermKind::SinCos:
+                {
+                    double sg, cg;
+                    sincos_value(gx, sg, cg);
+                    result += t.coefficient * sg + t.cos_coefficient * cg;
+                    break;
+                }
+            }
+        }
+        if (!expr.empty()) result += run_tape(expr, x);
+        return result;
+    }
+
+    // -------------------------------------------------------------------------
+    //  derivate_evaluate
+    //
+    //    g(x)  = scale * x^n + offset   =>   g'(x) = scale * n * x^(n-1)
+    //
+    //    d/dx [ c * sin(g(x)) ] =  c * cos(g(x)) * g'(x)
+    //    d/dx [ c * cos(g(x)) ] = -c * sin(g(x)) * g'(x)
+    //    d/dx [ c * tan(g(x)) ] =  c * sec²(g(x)) * g'(x)
+    //    d/dx [ c * exp(g(x)) ] =  c * exp(g(x)) * g'(x)
+    //    d/dx [ c * x^N ]       =  c * N * x^(N-1)
+    // -------------------------------------------------------------------------
+
+    double Function::derivate_evaluate(double x) const
+    {
+        double fx, dfx;
+        evaluate_with_derivative(x, fx, dfx);
+        return dfx;
+    }
+
+    // -------------------------------------------------------------------------
+    //  evaluate_with_derivative
+    //
+    //  f(x) y f'(x) en una sola pasada (modo dual: cada término propaga
+    //  valor y derivada de g(x) a la vez). Para polinomios es Horner doble:
+    //    p  <- p*x + a_k
+    //    dp <- dp*x + p        (antes de actualizar p)
+    //  Para el resto se comparte x^(n-1) entre g(x) y g'(x) de cada término.
+    // -------------------------------------------------------------------------
+
+    void Function::evaluate_with_derivative(double x, double &fx, double &dfx) const
+    {
+        if (polynomial)
+        {
+            double p = 0.0, dp = 0.0;
+            for (std::size_t k = poly.size(); k-- > 0;)
+            {
+                dp = dp * x + p;
+                p  = p * x + poly[k];
+            }
+            fx = p;
+            dfx = dp;
+            return;
+        }
+
+        fx = 0.0;
+        dfx = 0.0;
+        int last_exponent = -1;
+        double xn1 = 0.0;
+        for (const Term &t : program)
+        {
+            if (t.exponent != last_exponent)
+            {
+                xn1 = (t.exponent == 0) ? 0.0 : ipow(x, t.exponent - 1);
+                last_exponent = t.exponent;
+            }
+            double gx  = (t.exponent == 0) ? t.scale + t.offset : t.scale * xn1 * x + t.offset;
+            double gpx = t.scale * t.exponent * xn1;
+            double c   = t.coefficient;
+            switch (t.kind)
+            {
+                case TermKind::Power:
+                    fx += c * gx;
+                    dfx += c * gpx;
+                    break;
+                case TermKind::Sin:
+                {
+                    double sg = std::sin(gx), cg = std::cos(gx);
+                    fx += c * sg;
+                    dfx += c * cg * gpx;
+                    break;
+                }
+                case TermKind::Cos:
+                {
+                    double sg = std::sin(gx), cg = std::cos(gx);
+                    fx += c * cg;
+                    dfx -= c * sg * gpx;
+                    break;
+                }
+                case TermKind::SinCos:
+                {
+                    double sg, cg;
+                    sincos_value(gx, sg, cg);
+                    double c2 = t.cos_coefficient;
+                    fx += c * sg + c2 * cg;
+                    dfx += (c * cg - c2 * sg) * gpx;
+                    break;
+                }
+                case TermKind::Tan:
+                {
+                    double tg = std::tan(gx);
+                    fx += c * tg;
+                    dfx += c * (1.0 + tg * tg) * gpx;
+                    break;
+                }
+                case TermKind::Exp:
+                {
+                    double eg = std::exp(gx);
+                    fx += c * eg;
+                    dfx += c * eg * gpx;
+                    break;
+                }
+            }
+        }
+
+        if (!expr.empty())
+        {
+            Dual r = run_tape(expr, Dual{x, 1.0});
+            fx += r.value;
+            dfx += r.derivative;
+        }
+    }
+
+    // Regla de la cadena: f(u)' = f'(u) * u'
+    Dual Function::evaluate(Dual x) const
+    {
+        double fx, dfx;
+        evaluate_with_derivative(x.value, fx, dfx);
+        return {fx, dfx * x.derivative};
+    }
+
+    // -------------------------------------------------------------------------
+    //  evaluate(Interval)
+    //
+    //  Encierro garantizado de f sobre [x.lo, x.hi]: si 0 no está en el
+    //  resultado, f no tiene raíces en el intervalo. Cada término se evalúa
+    //  con la aritmética de intervalos; x^n usa el rango exacto de la
+    //  potencia (no productos), y para polinomios se suman c_k * x^k en vez
+    //  de Horner, que en intervalos arrastra la dependencia de x en cada paso.
+    // -------------------------------------------------------------------------
+
+    Interval Function::evaluate(Interval x) const
+    {
+        Interval result{0.0};
+        if (polynomial)
+        {
+            for (std::size_t k = 0; k < poly.size(); k++)
+                if (poly[k] != 0.0) result = result + poly[k] * pow(x, static_cast<int>(k));
+            return result;
+        }
+
+        int last_exponent = -1;
+        Interval xn;
+        for (const Term &t : program)
+        {
+            if (t.exponent != last_exponent)
+            {
+                xn = pow(x, t.exponent);
+                last_exponent = t.exponent;
+            }
+            Interval gx = t.scale * xn + t.offset;
+            switch (t.kind)
+            {
+                case TermKind::Power: result = result + t.coefficient * gx;      break;
+                case TermKind::Sin:   result = result + t.coefficient * sin(gx); break;
+                case TermKind::Cos:   result = result + t.coefficient * cos(gx); break;
+                case TermKind::Tan:   result = result + t.coefficient * tan(gx); break;
+                case TermKind::Exp:   result = result + t.coefficient * exp(gx); break;
+                case TermKind::SinCos:
+                    result = result + t.coefficient * sin(gx) + t.cos_coefficient * cos(gx);
+                    break;
+            }
+        }
+        if (!expr.empty()) result = result + run_tape(expr, x);
+        return result;
+    }
+
+    // -------------------------------------------------------------------------
+    //  evaluate_derivatives
+    //
+    //  derivatives[k] = f^(k)(x), k = 0..order (order ≤ MAX_TAYLOR_ORDER), con
+    //  aritmética de series de Taylor truncadas en un solo recorrido de los
+    //  términos. Con u_k los coeficientes de g(x+h) = Σ u_k h^k:
+    //
+    //    u_k     = scale * C(n,k) * x^(n-k)          (+ offset en u_0)
+    //    sin/cos:  s_k =  (1/k) Σ_{j=1..k} j u_j c_{k-j}
+    //              c_k = -(1/k) Σ_{j=1..k} j u_j s_{k-j}
+    //    exp:      e_k =  (1/k) Σ_{j=1..k} j u_j e_{k-j}
+    //    tan:      t_k = (s_k - Σ_{j=1..k} c_j t_{k-j}) / c_0
+    //
+    //  Para polinomios se usa Horner sintético (todas las derivadas en una
+    //  pasada sobre los coeficientes densos).
+    // -------------------------------------------------------------------------
+
+    void Function::evaluate_derivatives(double x, int order, double *derivatives) const
+    {
+        if (order < 0 || order > MAX_TAYLOR_ORDER)
+        {
+            std::cerr << "[Function::evaluate_derivatives] Order must be in [0, "
+                      << MAX_TAYLOR_ORDER << "], got " << order << "\n";
+            return;
+        }
+
+        constexpr int N = MAX_TAYLOR_ORDER + 1;
+        double total[N] = {};
+
+        if (polynomial)
+        {
+            const int degree = static_cast<int>(poly.size()) - 1;
+            for (int i = degree; i >= 0; i--)
+            {
+                for (int j = std::min(order, degree - i); j >= 1; j--)
+                    total[j] = total[j] * x + total[j - 1];
+                total[0] = total[0] * x + poly[i];
+            }
+        }
+        else
+        {
+            const int K = order + 1;
+            double u[N], s[N], c[N], t[N];
+            const Term *previous = nullptr;
+            for (const Term &term : program)
+            {
+                const double *series = u;
+                bool same_argument = previous && previous->exponent == term.exponent
+                    && previous->scale == term.scale && previous->offset == term.offset;
+                previous = &term;
+
+                // Serie de g(x+h) = scale * (x+h)^n + offset (se reutiliza si g no cambia)
+                if (!same_argument)
+                {
+                    const int n = term.exponent;
+                    const int kmax = std::min(order, n);
+                    double xp = ipow(x, n - kmax);
+                    for (int k = 0; k <= order; k++) u[k] = 0.0;
+                    for (int k = kmax; k >= 0; k--)
+                    {
+                        u[k] = xp;
+                        xp *= x;
+                    }
+                    double binom = 1.0;
+                    for (int k = 0; k <= kmax; k++)
+                    {
+                        u[k] *= term.scale * binom;
+                        binom = binom * (n - k) / (k + 1);
+                    }
+                    u[0] += term.offset;
+                }
+
+                switch (term.kind)
+                {
+                    case TermKind::Power:
+                        break;
+                    case TermKind::Sin:
+                        series_sincos(u, s, c, K);
+                        series = s;
+                        break;
+                    case TermKind::Cos:
+                        series_sincos(u, s, c, K);
+                        series = c;
+                        break;
+                    case TermKind::Tan:
+                        series_sincos(u, s, c, K);
+                        series_div(s, c, t, K);
+                        series = t;
+                        break;
+                    case TermKind::Exp:
+                        series_exp(u, t, K);
+                        series = t;
+                        break;
+                    case TermKind::SinCos:
+                        series_sincos(u, s, c, K);
+                        for (int k = 0; k <= order; k++)
+                            total[k] += term.coefficient * s[k] + term.cos_coefficient * c[k];
+                        continue;
+                }
+
+                for (int k = 0; k <= order; k++)
+                    total[k] += term.coefficient * series[k];
+            }
+
+            if (!expr.empty()) run_tape_taylor(expr, x, K, total);
+        }
+
+        // Coeficientes de Taylor -> derivadas: f^(k) = k! * c_k
+        double factorial = 1.0;
+        for (int k = 0; k <= order; k++)
+        {
+            if (k > 0) factorial *= k;
+            derivatives[k] = total[k] * factorial;
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    //  Núcleos vectoriales de sin, cos y exp para evaluate_many
+    //
+    //  std::sin, std::cos y std::exp son llamadas a libm que el compilador no
+    //  vectoriza (salvo con -ffast-math y libmvec), así que un ciclo con un
+    //  término trascendente queda escalar aunque el resto sí se vectorice.
+    //  block_sincos y block_exp procesan el bloque de 4 en 4 doubles con
+    //  AVX2+FMA, usando las reducciones y polinomios de Cephes (1 a 2 ulp de
+    //  diferencia con libm):
+    //    - sin/cos: k = octante de |x| (múltiplo de π/4, redondeado a par),
+    //      z = |x| - k π/4 con π/4 en tres partes, y el polinomio de sin o de
+    //      cos de z según el octante; el signo sale de los bits de k.
+    //    - exp: x = n ln2 + r con ln2 en dos partes, aproximante de Padé para
+    //      e^r y 2^n armado directamente en los bits del exponente.
+    //  Un grupo de 4 con algún valor fuera del rango donde la reducción es
+    //  exacta (|x| ≥ 2^30 en sin/cos, fuera de [-708, 709] en exp, NaN o inf)
+    //  se recalcula con libm, igual que la cola del bloque. Si la CPU no tiene
+    //  AVX2 y FMA (se consulta una vez con __builtin_cpu_supports) o el
+    //  compilador no es GCC/Clang sobre x86, todo el bloque usa libm.
+    // -------------------------------------------------------------------------
+
+#ifdef NA_VECTOR_MATH
+    static bool cpu_has_avx2_fma()
+    {
+        static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        return supported;
+    }
+
+    __attribute__((target("avx2,fma")))
+    static void sincos_avx2(const double *v, double *s, double *c, std::size_t len)
+    {
+        const __m256d sign_bit     = _mm256_set1_pd(-0.0);
+        const __m256d four_over_pi = _mm256_set1_pd(1.27323954473516268615);
+        const __m256d dp1          = _mm256_set1_pd(7.85398125648498535156e-1);
+        const __m256d dp2          = _mm256_set1_pd(3.77489470793079817668e-8);
+        const __m256d dp3          = _mm256_set1_pd(2.69515142907905952645e-15);
+        const __m256d limit        = _mm256_set1_pd(1073741824.0);
+        const __m256d one          = _mm256_set1_pd(1.0);
+        const __m256d half         = _mm256_set1_pd(0.5);
+
+        std::size_t i = 0;
+        for (; i + 4 <= len; i += 4)
+        {
+            const __m256d x  = _mm256_loadu_pd(v + i);
+            const __m256d ax = _mm256_andnot_pd(sign_bit, x);
+            if (_mm256_movemask_pd(_mm256_cmp_pd(ax, limit, _CMP_LT_OQ)) != 0xF)
+            {
+                for (std::size_t k = i; k < i + 4; k++)
+                {
+                    if (s) s[k] = std::sin(v[k]);
+                    if (c) c[k] = std::cos(v[k]);
+                }
+                continue;
+            }
+
+            // Octante, redondeado a par: k = 0, 2, 4 o 6 (mod 8)
+            __m256d y   = _mm256_floor_pd(_mm256_mul_pd(ax, four_over_pi));
+            __m128i k   = _mm256_cvttpd_epi32(y);
+            __m128i odd = _mm_and_si128(k, _mm_set1_epi32(1));
+            k = _mm_add_epi32(k, odd);
+            y = _mm256_add_pd(y, _mm256_cvtepi32_pd(odd));
+
+            __m256d z = _mm256_fnmadd_pd(y, dp1, ax);
+            z = _mm256_fnmadd_pd(y, dp2, z);
+            z = _mm256_fnmadd_pd(y, dp3, z);
+            const __m256d zz = _mm256_mul_pd(z, z);
+
+            __m256d ps = _mm256_set1_pd(1.58962301576546568060e-10);
+            ps = _mm256_fmadd_pd(ps, zz, _mm256_set1_pd(-2.50507477628578072866e-8));
+            ps = _mm256_fmadd_pd(ps, zz, _mm256_set1_pd(2.75573136213857245213e-6));
+            ps = _mm256_fmadd_pd(ps, zz, _mm256_set1_pd(-1.98412698295895385996e-4));
+            ps = _mm256_fmadd_pd(ps, zz, _mm256_set1_pd(8.33333333332211858878e-3));
+            ps = _mm256_fmadd_pd(ps, zz, _mm256_set1_pd(-1.66666666666666307295e-1));
+            const __m256d sin_z = _mm256_fmadd_pd(_mm256_mul_pd(z, zz), ps, z);
+
+            __m256d pc = _mm256_set1_pd(-1.13585365213876817300e-11);
+            pc = _mm256_fmadd_pd(pc, zz, _mm256_set1_pd(2.08757008419747316778e-9));
+            pc = _mm256_fmadd_pd(pc, zz, _mm256_set1_pd(-2.75573141792967388112e-7));
+            pc = _mm256_fmadd_pd(pc, zz, _mm256_set1_pd(2.48015872888517045348e-5));
+            pc = _mm256_fmadd_pd(pc, zz, _mm256_set1_pd(-1.38888888888730564116e-3));
+            pc = _mm256_fmadd_pd(pc, zz, _mm256_set1_pd(4.16666666666665929218e-2));
+            const __m256d cos_z = _mm256_fmadd_pd(_mm256_mul_pd(zz, zz), pc, _mm256_fnmadd_pd(half, zz, one));
+
+            // Bit 2 de k: se intercambian los polinomios; bit 4: cambia el signo
+            // de sin; bit 2 xor bit 4: cambia el signo de cos
+            const __m256d swap  = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(
+                                      _mm_cmpeq_epi32(_mm_and_si128(k, _mm_set1_epi32(2)), _mm_set1_epi32(2))));
+            const __m256d upper = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(
+                                      _mm_cmpeq_epi32(_mm_and_si128(k, _mm_set1_epi32(4)), _mm_set1_epi32(4))));
+
+            if (s)
+            {
+                __m256d r    = _mm256_blendv_pd(sin_z, cos_z, swap);
+                __m256d sign = _mm256_xor_pd(_mm256_and_pd(x, sign_bit), _mm256_and_pd(upper, sign_bit));
+                _mm256_storeu_pd(s + i, _mm256_xor_pd(r, sign));
+            }
+            if (c)
+            {
+                __m256d r    = _mm256_blendv_pd(cos_z, sin_z, swap);
+                __m256d sign = _mm256_and_pd(_mm256_xor_pd(upper, swap), sign_bit);
+                _mm256_storeu_pd(c + i, _mm256_xor_pd(r, sign));
+            }
+        }
+        for (; i < len; i++)
+        {
+            if (s) s[i] = std::sin(v[i]);
+            if (c) c[i] = std::cos(v[i]);
+        }
+    }
+
+    __attribute__((target("avx2,fma")))
+    static void exp_avx2(const double *v, double *e, std::size_t len)
+    {
+        const __m256d lower = _mm256_set1_pd(-708.0);
+        const __m256d upper = _mm256_set1_pd(709.0);
+        const __m256d log2e = _mm256_set1_pd(1.4426950408889634073599);
+        const __m256d c1    = _mm256_set1_pd(6.93145751953125e-1);
+        const __m256d c2    = _mm256_set1_pd(1.42860682030941723212e-6);
+        const __m256d one   = _mm256_set1_pd(1.0);
+        const __m256d two   = _mm256_set1_pd(2.0);
+
+        std::size_t i = 0;
+        for (; i + 4 <= len; i += 4)
+        {
+            __m256d x = _mm256_loadu_pd(v + i);
+            const __m256d inside = _mm256_and_pd(_mm256_cmp_pd(x, lower, _CMP_GE_OQ), _mm256_cmp_pd(x, upper, _CMP_LE_OQ));
+            if (_mm256_movemask_pd(inside) != 0xF)
+            {
+                for (std::size_t k = i; k < i + 4; k++) e[k] = std::exp(v[k]);
+                continue;
+            }
+
+            const __m256d n = _mm256_floor_pd(_mm256_fmadd_pd(x, log2e, _mm256_set1_pd(0.5)));
+            x = _mm256_fnmadd_pd(n, c1, x);
+            x = _mm256_fnmadd_pd(n, c2, x);
+            const __m256d xx = _mm256_mul_pd(x, x);
+
+            __m256d p = _mm256_set1_pd(1.26177193074810590878e-4);
+            p = _mm256_fmadd_pd(p, xx, _mm256_set1_pd(3.02994407707441961300e-2));
+            p = _mm256_fmadd_pd(p, xx, _mm256_set1_pd(9.99999999999999999910e-1));
+            p = _mm256_mul_pd(p, x);
+            __m256d q = _mm256_set1_pd(3.00198505138664455042e-6);
+            q = _mm256_fmadd_pd(q, xx, _mm256_set1_pd(2.52448340349684104192e-3));
+            q = _mm256_fmadd_pd(q, xx, _mm256_set1_pd(2.27265548208155028766e-1));
+            q = _mm256_fmadd_pd(q, xx, _mm256_set1_pd(2.00000000000000000009e0));
+            const __m256d er = _mm256_fmadd_pd(two, _mm256_div_pd(p, _mm256_sub_pd(q, p)), one);
+
+            // 2^n: n + 1023 en el campo del exponente (n está en [-1022, 1023])
+            const __m256i bits = _mm256_slli_epi64(
+                _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(n)), _mm256_set1_epi64x(1023)), 52);
+            _mm256_storeu_pd(e + i, _mm256_mul_pd(er, _mm256_castsi256_pd(bits)));
+        }
+        for (; i < len; i++) e[i] = std::exp(v[i]);
+    }
+#endif
+
+    // s[i] = sin(v[i]) y c[i] = cos(v[i]); s o c pueden ser nullptr
+    static void block_sincos(const double *v, double *s, double *c, std::size_t len)
+    {
+#ifdef NA_VECTOR_MATH
+        if (cpu_has_avx2_fma())
+        {
+            sincos_avx2(v, s, c, len);
+            return;
+        }
+#endif
+        if (s) for (std::size_t i = 0; i < len; i++) s[i] = std::sin(v[i]);
+        if (c) for (std::size_t i = 0; i < len; i++) c[i] = std::cos(v[i]);
+    }
+
+    static void block_exp(const double *v, double *e, std::size_t len)
+    {
+#ifdef NA_VECTOR_MATH
+        if (cpu_has_avx2_fma())
+        {
+            exp_avx2(v, e, len);
+            return;
+        }
+#endif
+        for (std::size_t i = 0; i < len; i++) e[i] = std::exp(v[i]);
+    }
+
+    // -------------------------------------------------------------------------
+    //  evaluate_many / derivate_evaluate_many
+    //
+    //  Evaluación por lotes: out[i] = f(xs[i]). Se recorre el lote en bloques
+    //  de EVAL_BLOCK puntos y, dentro de cada bloque, término por término, de
+    //  modo que cada ciclo interno es una operación uniforme sobre un arreglo
+    //  contiguo. Los ciclos aritméticos (potencias, Horner, argumentos y
+    //  acumulación) los vectoriza el compilador; sin, cos, tan y exp pasan
+    //  por block_sincos y block_exp. Los bloques caben en L1, así que el
+    //  lote puede ser de cualquier tamaño sin memoria auxiliar en el heap.
+    // -------------------------------------------------------------------------
+
+    void Function::evaluate_many(std::span<const double> xs, std::span<double> out) const
+    {
+        if (out.size() < xs.size())
+        {
+            std::cerr << "[Function::evaluate_many] Output span is smaller than input ("
+                      << out.size() << " < " << xs.size() << ")\n";
+            return;
+        }
+
+        double g[EVAL_BLOCK];
+        double base[EVAL_BLOCK];
+        double arg[EVAL_BLOCK];
+        double t1[EVAL_BLOCK];
+        double t2[EVAL_BLOCK];
+
+        for (std::size_t start = 0; start < xs.size(); start += EVAL_BLOCK)
+        {
+            const std::size_t len = std::min(EVAL_BLOCK, xs.size() - start);
+            const double *x = xs.data() + start;
+            double       *y = out.data() + start;
+
+            for (std::size_t i = 0; i < len; i++) y[i] = 0.0;
+
+            if (polynomial)
+            {
+                for (std::size_t k = poly.size(); k-- > 0;)
+                {
+                    const double ak = poly[k];
+                    for (std::size_t i = 0; i < len; i++) y[i] = y[i] * x[i] + ak;
+                }
+                continue;
+            }
+
+            int last_exponent = -1;
+            for (const Term &t : program)
+            {
+                if (t.exponent != last_exponent)
+                {
+                    power_block(x, g, base, len, t.exponent);
+                    last_exponent = t.exponent;
+                }
+                const double c = t.coefficient, s = t.scale, o = t.offset;
+                if (t.kind == TermKind::Power)
+                {
+                    for (std::size_t i = 0; i < len; i++) y[i] += c * (s * g[i] + o);
+                    continue;
+                }
+
+                for (std::size_t i = 0; i < len; i++) arg[i] = s * g[i] + o;
+                switch (t.kind)
+                {
+                    case TermKind::Sin:
+                        block_sincos(arg, t1, nullptr, len);
+                        for (std::size_t i = 0; i < len; i++) y[i] += c * t1[i];
+                        break;
+                    case TermKind::Cos:
+                        block_sincos(arg, nullptr, t1, len);
+                        for (std::size_t i = 0; i < len; i++) y[i] += c * t1[i];
+                        break;
+                    case TermKind::Tan:
+                        block_sincos(arg, t1, t2, len);
+                        for (std::size_t i = 0; i < len; i++) y[i] += c * (t1[i] / t2[i]);
+                        break;
+                    case TermKind::Exp:
+                        block_exp(arg, t1, len);
+                        for (std::size_t i = 0; i < len; i++) y[i] += c * t1[i];
+                        break;
+                    case TermKind::SinCos:
+                    {
+                        const double c2 = t.cos_coefficient;
+                        block_sincos(arg, t1, t2, len);
+                        for (std::size_t i = 0; i < len; i++) y[i] += c * t1[i] + c2 * t2[i];
+                        break;
+                    }
+                    case TermKind::Power:
+                        break;
+                }
+            }
+
+            if (!expr.empty()) run_tape_block(expr, x, y, len);
+        }
+    }
+
+    void Function::derivate_evaluate_many(std::span<const double> xs, std::span<double> out) const
+    {
+        if (out.size() < xs.size())
+        {
+            std::cerr << "[Function::derivate_evaluate_many] Output span is smaller than input ("
+                      << out.size() << " < " << xs.size() << ")\n";
+            return;
+        }
+
+        double g[EVAL_BLOCK];
+        double base[EVAL_BLOCK];
+        double arg[EVAL_BLOCK];
+        double t1[EVAL_BLOCK];
+        double t2[EVAL_BLOCK];
+
+        for (std::size_t start = 0; start < xs.size(); start += EVAL_BLOCK)
+        {
+            const std::size_t len = std::min(EVAL_BLOCK, xs.size() - start);
+            const double *x = xs.data() + start;
+            double       *y = out.data() + start;
+
+            for (std::size_t i = 0; i < len; i++) y[i] = 0.0;
+
+            if (polynomial)
+            {
+                // Horner doble; g acumula p(x) y y acumula p'(x)
+                for (std::size_t i = 0; i < len; i++) g[i] = 0.0;
+                for (std::size_t k = poly.size(); k-- > 0;)
+                {
+                    const double ak = poly[k];
+                    for (std::size_t i = 0; i < len; i++)
+                    {
+                        y[i] = y[i] * x[i] + g[i];
+                        g[i] = g[i] * x[i] + ak;
+                    }
+                }
+                continue;
+            }
+
+            int last_exponent = -1;
+            for (const Term &t : program)
+            {
+                if (t.exponent == 0 || t.scale == 0.0) continue;
+
+                // g = x^(n-1);  g'(x) = s*n*g,  g(x) = s*g*x + o
+                if (t.exponent != last_exponent)
+                {
+                    power_block(x, g, base, len, t.exponent - 1);
+                    last_exponent = t.exponent;
+                }
+                const double c = t.coefficient, s = t.scale, o = t.offset;
+                const double sn = s * t.exponent;
+                if (t.kind == TermKind::Power)
+                {
+                    for (std::size_t i = 0; i < len; i++) y[i] += c * sn * g[i];
+                    continue;
+                }
+
+                for (std::size_t i = 0; i < len; i++) arg[i] = s * g[i] * x[i] + o;
+                switch (t.kind)
+                {
+                    case TermKind::Sin:
+                        block_sincos(arg, nullptr, t1, len);
+                        for (std::size_t i = 0; i < len; i++) y[i] += c * t1[i] * sn * g[i];
+                        break;
+                    case TermKind::Cos:
+                        block_sincos(arg, t1, nullptr, len);
+                        for (std::size_t i = 0; i < len; i++) y[i] -= c * t1[i] * sn * g[i];
+                        break;
+                    case TermKind::Tan:
+                        block_sincos(arg, nullptr, t1, len);
+                        for (std::size_t i = 0; i < len; i++)
+                        {
+                            double sec = 1.0 / t1[i];
+                            y[i] += c * sec * sec * sn * g[i];
+                        }
+                        break;
+                    case TermKind::Exp:
+                        block_exp(arg, t1, len);
+                        for (std::size_t i = 0; i < len; i++) y[i] += c * t1[i] * sn * g[i];
+                        break;
+                    case TermKind::SinCos:
+                    {
+                        const double c2 = t.cos_coefficient;
+                        block_sincos(arg, t1, t2, len);
+                        for (std::size_t i = 0; i < len; i++) y[i] += (c * t2[i] - c2 * t1[i]) * sn * g[i];
+                        break;
+                    }
+                    case TermKind::Power:
+                        break;
+                }
+            }
+
+            if (!expr.empty())
+                for (std::size_t i = 0; i < len; i++)
+                    y[i] += run_tape(expr, Dual{x[i], 1.0}).derivative;
+        }
+    }
+
+    float Function::get(const std::string &key) const
+    {
+        auto it = coeff.find(normalize_key(key));
+        return (it != coeff.end()) ? it->second : 0.0f;
+    }
+
+    bool Function::contains(const std::string &key) const
+    {
+        return coeff.count(normalize_key(key)) != 0;
+    }
+
+    void Function::update(const std::string &key, float val)
+    {
+        if (!valid_key(key))
+        {
+            std::cerr << "[Function::update] Invalid key: \"" << key << "\"\n";
+            return;
+        }
+        auto it = coeff.find(normalize_key(key));
+        if (it != coeff.end())
+        {
+            it->second = val;
+            compile();
+        }
+        else
+            std::cout << "[Function::update] Term \"" << key
+                      << "\" does not exist; use add() instead.\n";
+    }
+
+    void Function::add(const std::string &key, float val)
+    {
+        if (!valid_key(key))
+        {
+            std::cerr << "[Function::add] Invalid key: \"" << key << "\"\n";
+            return;
+        }
+        std::string canonical = normalize_key(key);
+        if (coeff.count(canonical))
+            std::cout << "[Function::add] Term \"" << key
+                      << "\" already exists; use update() to change it.\n";
+        else
+        {
+            coeff.emplace(canonical, val);
+            compile();
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    //  extract_expression
+    //
+    //  Parses expressions such as:
+    //    "3x^2 + 2sin(x) - 5cos(x^2) + tan(x^3) - 7"
+    //    "x*e^(-x^2) + sin(2x + 1)/sqrt(x) - ln(x)"
+    //
+    //  RULES
+    //  -----
+    //  • Single pass recursive descent (see ExpressionParser): + - * / ^,
+    //    implicit products (3x, 2sin(x)), parentheses, sin cos tan exp ln
+    //    log sqrt, e^(...), and the constants pi and e.
+    //  • Numbers may carry a decimal exponent: 1e5, 2.5e-3x. An 'e' glued to
+    //    a number and followed by digits is always the exponent; write
+    //    "2e - 3x" or "2*e-3x" for the constant.
+    //  • Functions MUST be followed by a parenthesised argument. Writing bare
+    //    "sin", "cos", or "tan" without parens throws std::invalid_argument,
+    //    as does any other syntax error.
+    //  • Each top-level term of the form c*x^N, c*sin/cos/tan(x^N) or
+    //    c*e^(a x^n) is stored under its usual coeff key ("x" inside parens is
+    //    normalised to "x^1"), so get/update/add keep working on it.
+    //  • Every other term (sin(x+1), x*ln(x), ...) is appended to the residual
+    //    expression tape, which is evaluated after the compiled terms.
+    // -------------------------------------------------------------------------
+
+    void Function::extract_expression(const std::string &expression)
+    {
+        std::vector<ExprNode> nodes;
+        nodes.reserve(expression.size());
+        ExpressionParser(expression, nodes).parse();
+        simplify_expression(nodes);
+        if (nodes.empty()) { compile(); return; }
+
+        std::vector<std::pair<int, double>> terms;
+        collect_terms(nodes, static_cast<int>(nodes.size()) - 1, 1.0, terms);
+
+        for (const auto &[node, sign] : terms)
+        {
+            double factor = sign;
+            int core = split_constant_factor(nodes, node, factor);
+
+            std::string key;
+            if (core < 0)
+                key = "x^0";
+            else if (!legacy_key(nodes, core, key))
+            {
+                if (factor == 0.0) continue;
+                int previous = static_cast<int>(expr.size()) - 1;
+                bool subtract = previous >= 0 && factor < 0.0;
+                if (subtract) factor = -factor;
+
+                int term = copy_subtree(nodes, core, expr);
+                if (factor == -1.0)
+                    expr.push_back({ExprOp::Neg, term});
+                else if (factor != 1.0)
+                {
+                    expr.push_back({ExprOp::Const, -1, -1, factor});
+                    expr.push_back({ExprOp::Mul, static_cast<int>(expr.size()) - 1, term});
+                }
+                if (previous >= 0)
+                    expr.push_back({subtract ? ExprOp::Sub : ExprOp::Add,
+                                    previous, static_cast<int>(expr.size()) - 1});
+                continue;
+            }
+
+            coeff[key] += factor;
+        }
+
+        simplify_expression(expr);
+        compile();
+    }
+
+    void Function::print() const
+    {
+        std::cout << "f(x) =";
+        bool first = true;
+        for (const auto &[key, coef] : coeff)
+        {
+            std::string prefix;
+            if (first) { prefix = " "; first = false; }
+            else        prefix = (coef >= 0) ? " + " : " - ";
+            std::cout << prefix;
+
+            float display = (coef < 0 && prefix != " ") ? -coef : coef;
+            if (prefix == " " && coef < 0) { std::cout << "-"; display = -coef; }
+
+            if (std::fabs(display - 1.0f) > 1e-6f || key == "x^0")
+                std::cout << display;
+
+            if (key != "x^0") std::cout << key;
+        }
+        if (!expr.empty())
+        {
+            int root = static_cast<int>(expr.size()) - 1;
+            if (!first && expr[root].op == ExprOp::Neg)
+                std::cout << " - " << expression_to_string(expr, expr[root].lhs);
+            else
+                std::cout << (first ? " " : " + ") << expression_to_string(expr, root);
+        }
+        std::cout << "\n";
+    }
+
+ 
+    // =====================================================================
+    //  Matrix class implementation
+    // =====================================================================
+
+    Matrix::Matrix() : rows(0), columns(0), leading(0) {}
+
+    Matrix::Matrix(const std::string& filename) : rows(0), columns(0), leading(0)
+    {
+        read_from_file(filename);
+    }
+
+    Matrix::Matrix(int rows, int columns)
+        : storage(static_cast<std::size_t>(std::max(rows, 0)) * padded(std::max(columns, 0)), 0.0),
+          rows(std::max(rows, 0)), columns(std::max(columns, 0)), leading(padded(std::max(columns, 0))) {}
+
+    Matrix::Matrix(const std::vector<std::vector<double>>& data)
+        : Matrix(static_cast<int>(data.size()), data.empty() ? 0 : static_cast<int>(data[0].size()))
+    {
+        for (int i = 0; i < rows; i++)
+            std::copy_n(data[i].begin(), std::min<std::size_t>(data[i].size(), columns), row(i));
+    }
+
+    Matrix::Matrix(Matrix&& other) noexcept
+        : storage(std::move(other.storage)),
+          rows(std::exchange(other.rows, 0)),
+          columns(std::exchange(other.columns, 0)),
+          leading(std::exchange(other.leading, 0)) {}
+
+    Matrix& Matrix::operator=(Matrix&& other) noexcept
+    {
+        if (this == &other) return *this;
+        storage = std::move(other.storage);
+        other.storage.clear();
+        rows    = std::exchange(other.rows, 0);
+        columns = std::exchange(other.columns, 0);
+        leading = std::exchange(other.leading, 0);
+        return *this;
+    }
+
+    void Matrix::resize(int rows, int columns)
+    {
+        if (rows == this->rows && columns == this->columns) return;
+        *this = Matrix(rows, columns);
+    }
+
+    Matrix& Matrix::operator+=(const Matrix& other)
+    {
+        add(other);
+        return *this;
+    }
+
+    Matrix& Matrix::operator-=(const Matrix& other)
+    {
+        subtract(other);
+        return *this;
+    }
+
+    Matrix& Matrix::operator*=(double factor)
+    {
+        for (double &v : storage) v *= factor;
+        return *this;
+    }
+
+    void Matrix::swap_rows(int a, int b)
+    {
+        if (a != b) std::swap_ranges(row(a), row(a) + columns, row(b));
+    }
+
+    void Matrix::set(int row, int column, double value)
+    {
+        if (row < 0 || row >= rows || column < 0 || column >= columns)
+        {
+            std::cerr << "[Matrix::set] Index out of bounds ("
+                      << row << ", " << column << ")\n";
+            return;
+        }
+        (*this)(row, column) = value;
+    }
+
+    double Matrix::get(int row, int column) const
+    {
+        if (row < 0 || row >= rows || column < 0 || column >= columns)
+        {
+            std::cerr << "[Matrix::get] Index out of bounds ("
+                      << row << ", " << column << ")\n";
+            return 0.0;
+        }
+        return (*this)(row, column);
+    }
+
+    int Matrix::getRows() const { return rows; }
+    int Matrix::getCols() const { return columns; }
+
+    void Matrix::print() const
+    {
+        for (int i = 0; i < rows; i++)
+        {
+            std::cout << "| ";
+            for (int j = 0; j < columns; j++)
+                std::cout << std::setw(10) << std::fixed
+                          << std::setprecision(4) << (*this)(i, j) << " ";
+            std::cout << "|\n";
+        }
+    }
+
+    // Mismas dimensiones implican mismo stride: el relleno también se
+    // recorre (vale 0 en ambos) y el bucle queda plano y vectorizable
+    void Matrix::add(const Matrix& other)
+    {
+        if (rows != other.rows || columns != other.columns)
+        {
+            std::cerr << "[Matrix::add] Dimension mismatch\n";
+            return;
+        }
+        for (std::size_t k = 0; k < storage.size(); k++)
+            storage[k] += other.storage[k];
+    }
+
+    void Matrix::subtract(const Matrix& other)
+    {
+        if (rows != other.rows || columns != other.columns)
+        {
+            std::cerr << "[Matrix::subtract] Dimension mismatch\n";
+            return;
+        }
+        for (std::size_t k = 0; k < storage.size(); k++)
+            storage[k] -= other.storage[k];
+    }
+
+    void Matrix::multiply(const Matrix& other)
+    {
+        if (columns != other.rows)
+        {
+            std::cerr << "[Matrix::multiply] Incompatible dimensions ("
                       << rows << "x" << columns << ") * ("
                       << other.rows << "x" << other.columns << ")\n";
             return;
         }
-        std::vector<std::vector<double>> result(
-            rows, std::vector<double>(other.columns, 0.0));
-        for (int i = 0; i < rows; i++)
-            for (int j = 0; j < other.columns; j++)
-                for (int k = 0; k < columns; k++)
-                    result[i][j] += data[i][k] * other.data[k][j];
-        data = result;
-        columns = other.columns;
+        Matrix result(rows, other.columns);
+        gemm(1.0, *this, other, 0.0, result);
+        *this = std::move(result);
+    }
+
+    void Matrix::divide(const Matrix& other)
+    {
+        if (rows != other.rows || columns != other.columns)
+        {
+            std::cerr << "[Matrix::divide] Dimension mismatch\n";
+            return;
+        }
+        for (int i = 0; i < rows; i++)
+        {
+            double       *a = row(i);
+            const double *b = other.row(i);
+            for (int j = 0; j < columns; j++)
+            {
+                if (std::abs(b[j]) < 1e-12)
+                {
+                    std::cerr << "[Matrix::divide] Division by zero at ("
+                              << i << ", " << j << ")\n";
+                    return;
+                }
+                a[j] /= b[j];
+            }
+        }
+    }
+
+    void Matrix::transpose()
+    {
+        Matrix result(columns, rows);
+        for (int i = 0; i < rows; i++)
+        {
+            const double *a = row(i);
+            for (int j = 0; j < columns; j++)
+                result(j, i) = a[j];
+        }
+        *this = std::move(result);
+    }
+
+    // inverse y determinant salen de la misma factorización PA = LU por
+    // bloques que usan los sistemas lineales (LUDecomposition)
+    void Matrix::inverse()
+    {
+        if (rows != columns)
+        {
+            std::cerr << "[Matrix::inverse] Matrix must be square\n";
+            return;
+        }
+        LUDecomposition lu(*this);
+        if (lu.singular())
+        {
+            std::cerr << "[Matrix::inverse] Singular matrix, cannot invert\n";
+            return;
+        }
+        *this = lu.inverse();
+    }
+
+    double Matrix::determinant()
+    {
+        if (rows != columns)
+        {
+            std::cerr << "[Matrix::determinant] Matrix must be square\n";
+            return 0.0;
+        }
+        return LUDecomposition(*this).determinant();
+    }
+
+    int Matrix::rank()
+    {
+        Matrix temp = *this;
+        int r = 0;
+        for (int col = 0; col < columns && r < rows; col++)
+        {
+            int pivot = -1;
+            for (int row = r; row < rows; row++)
+            {
+                if (std::abs(temp(row, col)) > 1e-12)
+                {
+                    pivot = row;
+                    break;
+                }
+            }
+            if (pivot == -1) continue;
+            temp.swap_rows(r, pivot);
+            const double *pivot_row = temp.row(r);
+            for (int row = r + 1; row < rows; row++)
+            {
+                if (std::abs(pivot_row[col]) < 1e-12) continue;
+                double *target = temp.row(row);
+                double  factor = target[col] / pivot_row[col];
+                for (int j = col; j < columns; j++)
+                    target[j] -= factor * pivot_row[j];
+            }
+            r++;
+        }
+        return r;
+    }
+
+    void Matrix::read_from_file(const std::string& filename)
+    {
+        std::ifstream file(filename);
+        if (!file.is_open())
+        {
+            std::cerr << "[Matrix::read_from_file] No se pudo abrir: "
+                      << filename << "\n";
+            return;
+        }
+
+        std::vector<std::vector<double>> data;
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if (line.empty()) continue;
+            std::istringstream iss(line);
+            std::vector<double> row;
+            std::string token;
+            while (iss >> token)
+            {
+                size_t slash = token.find('/');
+                if (slash != std::string::npos)
+                {
+                    double num = std::stod(token.substr(0, slash));
+                    double den = std::stod(token.substr(slash + 1));
+                    row.push_back(num / den);
+                }
+                else
+                {
+                    row.push_back(std::stod(token));
+                }
+            }
+            if (!row.empty())
+                data.push_back(row);
+        }
+
+        *this = Matrix(data);
+    }
+
+    void Matrix::write_to_file(const std::string& filename) const
+    {
+        std::ofstream file(filename);
+        if (!file.is_open())
+        {
+            std::cerr << "[Matrix::write_to_file] No se pudo abrir: "
+                      << filename << "\n";
+            return;
+        }
+
+        for (int i = 0; i < rows; i++)
+        {
+            for (int j = 0; j < columns; j++)
+            {
+                if (j > 0) file << " ";
+                file << (*this)(i, j);
+            }
+            file << "\n";
+        }
+    }
+
+    // =====================================================================
+    //  GEMM bloqueado y empaquetado
+    //
+    //    for jc (NC columnas de B)              -> bloque de B en L3
+    //      for pc (KC)                          -> empaqueta B[pc, jc]
+    //        for ic (MC filas de A), en paralelo -> empaqueta A[ic, pc] (L2)
+    //          for jr (NR) for ir (MR)          -> micro-kernel MR×NR
+    //
+    //  Los paneles empaquetados quedan contiguos en el orden en que el
+    //  micro-kernel los lee y se rellenan con ceros en los bordes, así el
+    //  kernel siempre hace el tile completo; el borde se recorta al
+    //  escribir en C.
+    // =====================================================================
+
+    static constexpr int GEMM_KC = 256;
+    static constexpr int GEMM_MC = 96;      // múltiplo del MR de todos los micro-kernels
+    static constexpr int GEMM_NC = 4096;
+
+    // Productos de menos de 2mnk = 2^24 flops (unos 200×200×200) van en un
+    // solo hilo: cada bloque (jc, pc) abre dos regiones paralelas y crear
+    // los hilos cuesta más de lo que se reparte.
+    static constexpr double      GEMM_PARALLEL_FLOPS = 16777216.0;
+    // Paneles de B por tarea al empaquetar (64 paneles kc×NR, del orden de
+    // 1 MB): empaquetar un solo panel es más barato que lanzar su hilo.
+    static constexpr std::size_t GEMM_PACK_GRAIN     = 64;
+
+    using AlignedBuffer = std::vector<double, AlignedAllocator<double>>;
+
+    // body(0), body(1), ..., body(N-1) con índices constantes: desenrolla
+    // el bucle sobre filas para que los acumuladores vivan en registros
+    template <int... I, typename Body>
+    static inline void gemm_unrolled(std::integer_sequence<int, I...>, Body &&body)
+    {
+        (body(std::integral_constant<int, I>{}), ...);
+    }
+
+    // -----------------------------------------------------------------
+    //  Micro-kernels: tile (MR×NR, por filas) = panel_a (kc×MR) * panel_b (kc×NR)
+    //
+    //  El de AVX-512 (12×16) y el de AVX2+FMA (6×8) se compilan con
+    //  target(...) y se eligen en tiempo de ejecución con
+    //  __builtin_cpu_supports, igual que los núcleos de evaluate_many; si
+    //  la CPU no tiene ninguno se usa el portable (4×8). Los de target no
+    //  usan gemm_unrolled: una lambda no hereda el target de la función
+    //  que la contiene y no podría usar los intrínsecos.
+    // -----------------------------------------------------------------
+
+    struct GemmKernelGeneric
+    {
+        static constexpr int MR = 4;
+        static constexpr int NR = 8;
+
+        static void run(int kc, const double *a, const double *b, double *tile)
+        {
+            constexpr auto rows = std::make_integer_sequence<int, MR>{};
+            double c[MR][NR] = {};
+            for (int k = 0; k < kc; k++, a += MR, b += NR)
+                gemm_unrolled(rows, [&](auto i)
+                {
+                    for (int j = 0; j < NR; j++) c[i][j] += a[i] * b[j];
+                });
+            for (int i = 0; i < MR; i++)
+                for (int j = 0; j < NR; j++)
+                    tile[i * NR + j] = c[i][j];
+        }
+    };
+
+#ifdef NA_VECTOR_MATH
+    static bool cpu_has_avx512f()
+    {
+        static const bool supported = __builtin_cpu_supports("avx512f");
+        return supported;
+    }
+
+    struct GemmKernelAvx2
+    {
+        static constexpr int MR = 6;
+        static constexpr int NR = 8;
+
+        __attribute__((target("avx2,fma")))
+        static void run(int kc, const double *a, const double *b, double *tile)
+        {
+            __m256d c0[MR], c1[MR];
+#pragma GCC unroll 16
+            for (int i = 0; i < MR; i++) c0[i] = c1[i] = _mm256_setzero_pd();
+            for (int k = 0; k < kc; k++, a += MR, b += NR)
+            {
+                __m256d b0 = _mm256_load_pd(b);
+                __m256d b1 = _mm256_load_pd(b + 4);
+#pragma GCC unroll 16
+                for (int i = 0; i < MR; i++)
+                {
+                    __m256d ai = _mm256_broadcast_sd(a + i);
+                    c0[i] = _mm256_fmadd_pd(ai, b0, c0[i]);
+                    c1[i] = _mm256_fmadd_pd(ai, b1, c1[i]);
+                }
+            }
+#pragma GCC unroll 16
+            for (int i = 0; i < MR; i++)
+            {
+                _mm256_store_pd(tile + i * NR,     c0[i]);
+                _mm256_store_pd(tile + i * NR + 4, c1[i]);
+            }
+        }
+    };
+
+    struct GemmKernelAvx512
+    {
+        static constexpr int MR = 12;
+        static constexpr int NR = 16;
+
+        __attribute__((target("avx512f")))
+        static void run(int kc, const double *a, const double *b, double *tile)
+        {
+            __m512d c0[MR], c1[MR];
+#pragma GCC unroll 16
+            for (int i = 0; i < MR; i++) c0[i] = c1[i] = _mm512_setzero_pd();
+            for (int k = 0; k < kc; k++, a += MR, b += NR)
+            {
+                __m512d b0 = _mm512_load_pd(b);
+                __m512d b1 = _mm512_load_pd(b + 8);
+#pragma GCC unroll 16
+                for (int i = 0; i < MR; i++)
+                {
+                    __m512d ai = _mm512_set1_pd(a[i]);
+                    c0[i] = _mm512_fmadd_pd(ai, b0, c0[i]);
+                    c1[i] = _mm512_fmadd_pd(ai, b1, c1[i]);
+                }
+            }
+#pragma GCC unroll 16
+            for (int i = 0; i < MR; i++)
+            {
+                _mm512_store_pd(tile + i * NR,     c0[i]);
+                _mm512_store_pd(tile + i * NR + 8, c1[i]);
+            }
+        }
+    };
+#endif
+
+    // a (mc×kc, stride lda) -> paneles de MR filas, columna a columna
+    template <int MR>
+    static void gemm_pack_a(const double *a, int lda, int mc, int kc, double *packed)
+    {
+        for (int p = 0; p < mc; p += MR)
+        {
+            int rows = std::min(MR, mc - p);
+            for (int r = 0; r < MR; r++)
+            {
+                if (r < rows)
+                {
+                    const double *src = a + static_cast<std::size_t>(p + r) * lda;
+                    for (int k = 0; k < kc; k++) packed[k * MR + r] = src[k];
+                }
+                else
+                    for (int k = 0; k < kc; k++) packed[k * MR + r] = 0.0;
+            }
+            packed += static_cast<std::size_t>(kc) * MR;
+        }
     }
 
-    void Matrix::divide(const Matrix& other)
+    // b (kc×columns, stride ldb, columns <= NR) -> un panel de NR columnas, fila a fila
+    template <int NR>
+    static void gemm_pack_b_panel(const double *b, int ldb, int kc, int columns, double *packed)
     {
-        if (rows != other.rows || columns != other.columns)
+        for (int k = 0; k < kc; k++, packed += NR)
         {
-            std::cerr << "[Matrix::divide] Dimension mismatch\n";
-            return;
+            const double *src = b + static_cast<std::size_t>(k) * ldb;
+            int j = 0;
+            for (; j < columns; j++) packed[j] = src[j];
+            for (; j < NR; j++) packed[j] = 0.0;
         }
-        for (int i = 0; i < rows; i++)
-            for (int j = 0; j < columns; j++)
+    }
+
+    // El cuerpo de gemm para un micro-kernel dado (MR y NR fijan el empaquetado)
+    template <typename Kernel>
+    static void gemm_blocked(int m, int n, int k, double alpha, const double *A, int lda, const double *B, int ldb,
+                             double beta, double *C, int ldc, int threads)
+    {
+        constexpr int MR = Kernel::MR, NR = Kernel::NR;
+        static_assert(GEMM_MC % MR == 0, "GEMM_MC debe ser múltiplo de MR");
+
+        AlignedBuffer packed_b(static_cast<std::size_t>(GEMM_KC) * ((std::min(n, GEMM_NC) + NR - 1) / NR) * NR);
+        const std::size_t m_blocks = static_cast<std::size_t>((m + GEMM_MC - 1) / GEMM_MC);
+
+        for (int jc = 0; jc < n; jc += GEMM_NC)
+        {
+            const int nc       = std::min(GEMM_NC, n - jc);
+            const int b_panels = (nc + NR - 1) / NR;
+            for (int pc = 0; pc < k; pc += GEMM_KC)
             {
-                if (std::abs(other.data[i][j]) < 1e-12)
+                const int    kc       = std::min(GEMM_KC, k - pc);
+                const double c_weight = (pc == 0) ? beta : 1.0;   // beta solo en el primer bloque de k
+
+                parallel_for(static_cast<std::size_t>(b_panels), [&](std::size_t begin, std::size_t end)
                 {
-                    std::cerr << "[Matrix::divide] Division by zero at ("
-                              << i << ", " << j << ")\n";
-                    return;
-                }
-                data[i][j] /= other.data[i][j];
+                    for (std::size_t q = begin; q < end; q++)
+                    {
+                        int j0 = static_cast<int>(q) * NR;
+                        gemm_pack_b_panel<NR>(B + static_cast<std::size_t>(pc) * ldb + jc + j0, ldb, kc,
+                                              std::min(NR, nc - j0), packed_b.data() + q * kc * NR);
+                    }
+                }, threads, GEMM_PACK_GRAIN);
+
+                parallel_for(m_blocks, [&](std::size_t begin, std::size_t end)
+                {
+                    AlignedBuffer packed_a(static_cast<std::size_t>(GEMM_MC) * kc);
+                    alignas(64) double tile[MR * NR];
+
+                    for (std::size_t block = begin; block < end; block++)
+                    {
+                        const int ic = static_cast<int>(block) * GEMM_MC;
+                        const int mc = std::min(GEMM_MC, m - ic);
+                        gemm_pack_a<MR>(A + static_cast<std::size_t>(ic) * lda + pc, lda, mc, kc, packed_a.data());
+
+                        for (int jr = 0; jr < nc; jr += NR)
+                        {
+                            const double *panel_b = packed_b.data() + static_cast<std::size_t>(jr / NR) * kc * NR;
+                            const int     cols    = std::min(NR, nc - jr);
+                            for (int ir = 0; ir < mc; ir += MR)
+                            {
+                                const double *panel_a = packed_a.data() + static_cast<std::size_t>(ir / MR) * kc * MR;
+                                Kernel::run(kc, panel_a, panel_b, tile);
+
+                                const int rows = std::min(MR, mc - ir);
+                                for (int i = 0; i < rows; i++)
+                                {
+                                    double       *c = C + static_cast<std::size_t>(ic + ir + i) * ldc + jc + jr;
+                                    const double *t = tile + i * NR;
+                                    if (c_weight == 0.0)
+                                        for (int j = 0; j < cols; j++) c[j] = alpha * t[j];
+                                    else
+                                        for (int j = 0; j < cols; j++) c[j] = alpha * t[j] + c_weight * c[j];
+                                }
+                            }
+                        }
+                    }
+                }, threads);
             }
+        }
     }
 
-    void Matrix::transpose()
+    void gemm(int m, int n, int k, double alpha, const double *A, int lda, const double *B, int ldb,
+              double beta, double *C, int ldc, int threads)
     {
-        std::vector<std::vector<double>> result(
-            columns, std::vector<double>(rows));
-        for (int i = 0; i < rows; i++)
-            for (int j = 0; j < columns; j++)
-                result[j][i] = data[i][j];
-        data = result;
-        std::swap(rows, columns);
+        if (m <= 0 || n <= 0) return;
+
+        // Sin producto que sumar: solo C = beta * C
+        if (k <= 0 || alpha == 0.0)
+        {
+            for (int i = 0; i < m; i++)
+            {
+                double *c = C + static_cast<std::size_t>(i) * ldc;
+                for (int j = 0; j < n; j++) c[j] = (beta == 0.0) ? 0.0 : beta * c[j];
+            }
+            return;
+        }
+
+        if (2.0 * m * n * k < GEMM_PARALLEL_FLOPS) threads = 1;
+
+#ifdef NA_VECTOR_MATH
+        if (cpu_has_avx512f())
+            return gemm_blocked<GemmKernelAvx512>(m, n, k, alpha, A, lda, B, ldb, beta, C, ldc, threads);
+        if (cpu_has_avx2_fma())
+            return gemm_blocked<GemmKernelAvx2>(m, n, k, alpha, A, lda, B, ldb, beta, C, ldc, threads);
+#endif
+        gemm_blocked<GemmKernelGeneric>(m, n, k, alpha, A, lda, B, ldb, beta, C, ldc, threads);
     }
 
-    void Matrix::inverse()
+    // ¿Se pisan las memorias de dos vistas con columnas contiguas? Cada una
+    // ocupa [data, data + (rows - 1) * row_stride + cols)
+    static bool views_overlap(ConstMatrixView a, ConstMatrixView b)
     {
-        if (rows != columns)
+        if (a.rows() == 0 || a.cols() == 0 || b.rows() == 0 || b.cols() == 0) return false;
+        const std::uintptr_t a_first = reinterpret_cast<std::uintptr_t>(a.data());
+        const std::uintptr_t b_first = reinterpret_cast<std::uintptr_t>(b.data());
+        const std::uintptr_t a_end   = a_first + (static_cast<std::size_t>(a.rows() - 1) * a.row_stride() + a.cols()) * sizeof(double);
+        const std::uintptr_t b_end   = b_first + (static_cast<std::size_t>(b.rows() - 1) * b.row_stride() + b.cols()) * sizeof(double);
+        return a_first < b_end && b_first < a_end;
+    }
+
+    void gemm(double alpha, ConstMatrixView A, ConstMatrixView B, double beta, MatrixView C, int threads)
+    {
+        const int m = A.getRows(), k = A.getCols(), n = B.getCols();
+        if (B.getRows() != k || C.getRows() != m || C.getCols() != n)
         {
-            std::cerr << "[Matrix::inverse] Matrix must be square\n";
+            std::cerr << "[gemm] Incompatible dimensions (" << m << "x" << k << ") * ("
+                      << B.getRows() << "x" << n << ") -> (" << C.getRows() << "x" << C.getCols() << ")\n";
             return;
         }
-        int n = rows;
-        std::vector<std::vector<double>> aug(n, std::vector<double>(2 * n, 0.0));
-        for (int i = 0; i < n; i++)
+        if (A.column_stride() != 1 || B.column_stride() != 1 || C.column_stride() != 1)
+        {
+            std::cerr << "[gemm] Las vistas deben tener columnas contiguas (copie la transpuesta con Matrix(v))\n";
+            return;
+        }
+        // Si C pisa a A o a B (la misma matriz o bloques que se solapan) el
+        // operando se copia antes de empaquetarlo, como en las expresiones
+        // que no son alias_safe: C se escribe mientras A y B se siguen leyendo
+        const bool a_aliased = views_overlap(C, A), b_aliased = views_overlap(C, B);
+        if (a_aliased || b_aliased)
         {
-            for (int j = 0; j < n; j++)
-                aug[i][j] = data[i][j];
-            aug[i][n + i] = 1.0;
+            Matrix a_copy, b_copy;
+            if (a_aliased) a_copy = A;
+            if (b_aliased) b_copy = B;
+            gemm(alpha, a_aliased ? ConstMatrixView(a_copy) : A, b_aliased ? ConstMatrixView(b_copy) : B, beta, C, threads);
+            return;
         }
+        gemm(m, n, k, alpha, A.data(), A.row_stride(), B.data(), B.row_stride(), beta, C.data(), C.row_stride(), threads);
+    }
 
-        for (int i = 0; i < n; i++)
+    // =====================================================================
+
+    const char* to_string(RootStatus status)
+    {
+        switch (status)
         {
-            int maxRow = i;
-            for (int k = i + 1; k < n; k++)
-                if (std::abs(aug[k][i]) > std::abs(aug[maxRow][i]))
-                    maxRow = k;
-            std::swap(aug[i], aug[maxRow]);
+            case RootStatus::Converged:      return "convergió";
+            case RootStatus::MaxIterations:  return "se agotaron las iteraciones";
+            case RootStatus::NoSignChange:   return "f(a) y f(b) tienen el mismo signo";
+            case RootStatus::ZeroDerivative: return "derivada o pendiente nula";
+            case RootStatus::InvalidInput:   return "entrada inválida";
+        }
+        return "desconocido";
+    }
 
-            if (std::abs(aug[i][i]) < 1e-12)
-            {
-                std::cerr << "[Matrix::inverse] Singular matrix, cannot invert\n";
-                return;
-            }
+    bool evaluate_tolerance(double xn, double xnp1, double tolerance)
+    {
+        double result = (xnp1 - xn) / xnp1;
+        result = std::abs(result);
+        if (result < tolerance) return true;
+        return false;
+    }
 
-            double pivot = aug[i][i];
-            for (int j = 0; j < 2 * n; j++)
-                aug[i][j] /= pivot;
+    // -----------------------------------------------------------------
+    //  Método de Householder de orden d
+    //
+    //    x_{n+1} = x_n + d * (1/f)^(d-1)(x_n) / (1/f)^(d)(x_n)
+    //
+    //  Con b_k los coeficientes de Taylor de 1/f (b_0 = 1/a_0,
+    //  b_k = -(Σ_{j=1..k} a_j b_{k-j}) / a_0) el paso se reduce a
+    //  b_{d-1} / b_d. d = 1 es Newton, d = 2 es Halley. Las derivadas
+    //  salen de una sola llamada a Function::evaluate_derivatives.
+    // -----------------------------------------------------------------
 
-            for (int k = 0; k < n; k++)
-            {
-                if (k != i)
-                {
-                    double factor = aug[k][i];
-                    for (int j = 0; j < 2 * n; j++)
-                        aug[k][j] -= factor * aug[i][j];
-                }
+    RootResult householder_method(const Function& func, double initial_point, double tolerance, int iterations, int order) {
+        RootCounter f(func);
+        if (order < 1 || order >= MAX_TAYLOR_ORDER) {
+            std::cerr << "[householder_method] El orden debe estar entre 1 y "
+                      << MAX_TAYLOR_ORDER - 1 << "\n";
+            return f.finish(RootStatus::InvalidInput, NAN, NAN, 0);
+        }
+        double point = initial_point;
+        double next_point;
+        double a[MAX_TAYLOR_ORDER + 1];
+        double b[MAX_TAYLOR_ORDER + 1];
+        for (int i = 0; i < iterations; i++){
+            func.evaluate_derivatives(point, order, a);
+            f.result.evaluations++;
+            f.result.derivative_evaluations++;
+            if (a[0] == 0) return f.finish(RootStatus::Converged, point, 0.0, i);
+
+            double factorial = 1.0;
+            for (int k = 1; k <= order; k++) {
+                factorial *= k;
+                a[k] /= factorial;
             }
+            b[0] = 1.0 / a[0];
+            for (int k = 1; k <= order; k++) {
+                double acc = 0.0;
+                for (int j = 1; j <= k; j++) acc += a[j] * b[k - j];
+                b[k] = -acc / a[0];
+            }
+            if (std::abs(b[order]) < 1e-300) return f.finish(RootStatus::ZeroDerivative, point, a[0], i);
+
+            next_point = point + b[order - 1] / b[order];
+            if (std::abs(next_point - point) < tolerance)
+                return f.finish(RootStatus::Converged, next_point, f(next_point), i + 1);
+            point = next_point;
         }
+        return f.finish(RootStatus::MaxIterations, point, f(point), iterations);
+    }
 
-        for (int i = 0; i < n; i++)
-            for (int j = 0; j < n; j++)
-                data[i][j] = aug[i][n + j];
+    RootResult halley_method(const Function& func, double initial_point, double tolerance, int iterations) {
+        return householder_method(func, initial_point, tolerance, iterations, 2);
     }
 
-    double Matrix::determinant()
+    // -----------------------------------------------------------------
+    //  Raíces de polinomios
+    // -----------------------------------------------------------------
+
+    // p(z) y p'(z) por Horner complejo; bound = Σ |a_k| |z|^k para la cota de error
+    static void horner_complex(const std::vector<double> &a, std::complex<double> z,
+                               std::complex<double> &p, std::complex<double> &dp, double &bound)
     {
-        if (rows != columns)
+        p = 0.0;
+        dp = 0.0;
+        bound = 0.0;
+        double r = std::abs(z);
+        for (std::size_t k = a.size(); k-- > 0;)
         {
-            std::cerr << "[Matrix::determinant] Matrix must be square\n";
-            return 0.0;
+            dp = dp * z + p;
+            p = p * z + a[k];
+            bound = bound * r + std::abs(a[k]);
         }
-        int n = rows;
-        auto temp = data;
-        double det = 1.0;
-        int sign = 1;
+    }
 
-        for (int i = 0; i < n; i++)
+    // Balanceo de Parlett–Reinsch: escala filas y columnas por potencias de 2
+    // para que tengan normas parecidas; no cambia los valores propios
+    static void balance(std::vector<double> &a, int n)
+    {
+        const double radix = 2.0, sqrdx = radix * radix;
+        bool done = false;
+        while (!done)
         {
-            int maxRow = i;
-            for (int k = i + 1; k < n; k++)
-                if (std::abs(temp[k][i]) > std::abs(temp[maxRow][i]))
-                    maxRow = k;
-            if (maxRow != i)
-            {
-                std::swap(temp[i], temp[maxRow]);
-                sign = -sign;
-            }
-            if (std::abs(temp[i][i]) < 1e-12)
-                return 0.0;
-            det *= temp[i][i];
-            for (int k = i + 1; k < n; k++)
+            done = true;
+            for (int i = 0; i < n; i++)
             {
-                double factor = temp[k][i] / temp[i][i];
-                for (int j = i + 1; j < n; j++)
-                    temp[k][j] -= factor * temp[i][j];
+                double r = 0.0, c = 0.0;
+                for (int j = 0; j < n; j++)
+                    if (j != i)
+                    {
+                        c += std::abs(a[j * n + i]);
+                        r += std::abs(a[i * n + j]);
+                    }
+                if (c == 0.0 || r == 0.0) continue;
+                double g = r / radix, f = 1.0, s = c + r;
+                while (c < g) { f *= radix; c *= sqrdx; }
+                g = r * radix;
+                while (c > g) { f /= radix; c /= sqrdx; }
+                if ((c + r) / f < 0.95 * s)
+                {
+                    done = false;
+                    g = 1.0 / f;
+                    for (int j = 0; j < n; j++) a[i * n + j] *= g;
+                    for (int j = 0; j < n; j++) a[j * n + i] *= f;
+                }
             }
         }
-        return sign * det;
     }
 
-    int Matrix::rank()
+    // -----------------------------------------------------------------
+    //  Valores propios de una matriz de Hessenberg superior (n×n, por
+    //  filas) con el QR de doble desplazamiento de Francis. Deflaciona
+    //  bloques 1×1 y 2×2 desde abajo; false si un valor propio no
+    //  converge en 30 iteraciones.
+    // -----------------------------------------------------------------
+
+    static bool hessenberg_eigenvalues(std::vector<double> &h, int n, std::vector<std::complex<double>> &eigenvalues)
     {
-        auto temp = data;
-        int r = 0;
-        for (int col = 0; col < columns && r < rows; col++)
+        auto a = [&](int i, int j) -> double & { return h[i * n + j]; };
+        auto sign = [](double v, double s) { return s >= 0.0 ? std::abs(v) : -std::abs(v); };
+
+        eigenvalues.assign(n, 0.0);
+        double anorm = 0.0;
+        for (int i = 0; i < n; i++)
+            for (int j = std::max(i - 1, 0); j < n; j++) anorm += std::abs(a(i, j));
+
+        int nn = n - 1;
+        double t = 0.0;
+        while (nn >= 0)
         {
-            int pivot = -1;
-            for (int row = r; row < rows; row++)
+            int its = 0, l;
+            do
             {
-                if (std::abs(temp[row][col]) > 1e-12)
+                // Busca un subdiagonal despreciable
+                for (l = nn; l >= 1; l--)
                 {
-                    pivot = row;
-                    break;
+                    double s = std::abs(a(l - 1, l - 1)) + std::abs(a(l, l));
+                    if (s == 0.0) s = anorm;
+                    if (std::abs(a(l, l - 1)) + s == s) { a(l, l - 1) = 0.0; break; }
                 }
-            }
-            if (pivot == -1) continue;
-            std::swap(temp[r], temp[pivot]);
-            for (int row = r + 1; row < rows; row++)
-            {
-                if (std::abs(temp[r][col]) < 1e-12) continue;
-                double factor = temp[row][col] / temp[r][col];
-                for (int j = col; j < columns; j++)
-                    temp[row][j] -= factor * temp[r][j];
-            }
-            r++;
+                double x = a(nn, nn);
+                if (l == nn)                                    // bloque 1×1
+                {
+                    eigenvalues[nn--] = x + t;
+                }
+                else
+                {
+                    double y = a(nn - 1, nn - 1);
+                    double w = a(nn, nn - 1) * a(nn - 1, nn);
+                    if (l == nn - 1)                            // bloque 2×2
+                    {
+                        double p = 0.5 * (y - x);
+                        double q = p * p + w;
+                        double z = std::sqrt(std::abs(q));
+                        x += t;
+                        if (q >= 0.0)
+                        {
+                            z = p + sign(z, p);
+                            eigenvalues[nn - 1] = eigenvalues[nn] = x + z;
+                            if (z != 0.0) eigenvalues[nn] = x - w / z;
+                        }
+                        else
+                        {
+                            eigenvalues[nn - 1] = {x + p,  z};
+                            eigenvalues[nn]     = {x + p, -z};
+                        }
+                        nn -= 2;
+                    }
+                    else
+                    {
+                        if (its == 30) return false;
+                        if (its == 10 || its == 20)             // desplazamiento excepcional
+                        {
+                            t += x;
+                            for (int i = 0; i <= nn; i++) a(i, i) -= x;
+                            double s = std::abs(a(nn, nn - 1)) + std::abs(a(nn - 1, nn - 2));
+                            y = x = 0.75 * s;
+                            w = -0.4375 * s * s;
+                        }
+                        ++its;
+
+                        int m;
+                        double p = 0.0, q = 0.0, r = 0.0, z;
+                        for (m = nn - 2; m >= l; m--)
+                        {
+                            z = a(m, m);
+                            r = x - z;
+                            double s = y - z;
+                            p = (r * s - w) / a(m + 1, m) + a(m, m + 1);
+                            q = a(m + 1, m + 1) - z - r - s;
+                            r = a(m + 2, m + 1);
+                            s = std::abs(p) + std::abs(q) + std::abs(r);
+                            p /= s; q /= s; r /= s;
+                            if (m == l) break;
+                            double u = std::abs(a(m, m - 1)) * (std::abs(q) + std::abs(r));
+                            double v = std::abs(p) * (std::abs(a(m - 1, m - 1)) + std::abs(z) + std::abs(a(m + 1, m + 1)));
+                            if (u + v == v) break;
+                        }
+                        for (int i = m + 2; i <= nn; i++)
+                        {
+                            a(i, i - 2) = 0.0;
+                            if (i != m + 2) a(i, i - 3) = 0.0;
+                        }
+                        for (int k = m; k <= nn - 1; k++)
+                        {
+                            if (k != m)
+                            {
+                                p = a(k, k - 1);
+                                q = a(k + 1, k - 1);
+                                r = (k != nn - 1) ? a(k + 2, k - 1) : 0.0;
+                                if ((x = std::abs(p) + std::abs(q) + std::abs(r)) != 0.0)
+                                {
+                                    p /= x; q /= x; r /= x;
+                                }
+                            }
+                            double s = sign(std::sqrt(p * p + q * q + r * r), p);
+                            if (s == 0.0) continue;
+                            if (k == m) { if (l != m) a(k, k - 1) = -a(k, k - 1); }
+                            else        a(k, k - 1) = -s * x;
+                            p += s;
+                            x = p / s; y = q / s; z = r / s;
+                            q /= p; r /= p;
+                            for (int j = k; j <= nn; j++)
+                            {
+                                p = a(k, j) + q * a(k + 1, j);
+                                if (k != nn - 1) { p += r * a(k + 2, j); a(k + 2, j) -= p * z; }
+                                a(k + 1, j) -= p * y;
+                                a(k, j) -= p * x;
+                            }
+                            int mmin = std::min(nn, k + 3);
+                            for (int i = l; i <= mmin; i++)
+                            {
+                                p = x * a(i, k) + y * a(i, k + 1);
+                                if (k != nn - 1) { p += z * a(i, k + 2); a(i, k + 2) -= p * r; }
+                                a(i, k + 1) -= p * q;
+                                a(i, k) -= p;
+                            }
+                        }
+                    }
+                }
+            } while (l < nn - 1);
         }
-        return r;
+        return true;
     }
 
-    void Matrix::read_from_file(const std::string& filename)
+    std::vector<std::complex<double>> polynomial_roots(const std::vector<double> &coefficients, int iterations)
     {
-        std::ifstream file(filename);
-        if (!file.is_open())
+        using complex = std::complex<double>;
+
+        // Grado real (sin ceros en la potencia más alta) y raíces en 0
+        std::size_t top = coefficients.size();
+        while (top > 0 && coefficients[top - 1] == 0.0) top--;
+        std::size_t zeros = 0;
+        while (zeros < top && coefficients[zeros] == 0.0) zeros++;
+        if (top == 0)
         {
-            std::cerr << "[Matrix::read_from_file] No se pudo abrir: "
-                      << filename << "\n";
-            return;
+            std::cerr << "[polynomial_roots] El polinomio es idénticamente cero\n";
+            return {};
         }
 
-        data.clear();
-        std::string line;
-        while (std::getline(file, line))
+        std::vector<double> a(coefficients.begin() + zeros, coefficients.begin() + top);
+        const int n = static_cast<int>(a.size()) - 1;
+        std::vector<complex> roots(zeros, 0.0);
+        if (n == 0) return roots;
+        if (n == 1)
         {
-            if (line.empty()) continue;
-            std::istringstream iss(line);
-            std::vector<double> row;
-            std::string token;
-            while (iss >> token)
+            roots.push_back(-a[0] / a[1]);
+            return roots;
+        }
+
+        // Aproximaciones iniciales: círculo de radio |a_0/a_n|^(1/n) con un
+        // desfase que rompe la simetría con el eje real
+        std::vector<complex> z(n);
+        double radius = std::pow(std::abs(a[0] / a[n]), 1.0 / n);
+        for (int k = 0; k < n; k++)
+            z[k] = std::polar(radius, 2.0 * PI * k / n + 0.4);
+
+        const double eps = 2.220446049250313e-16;
+        std::vector<char> done(n, 0);
+        int remaining = n;
+        for (int it = 0; it < iterations && remaining > 0; it++)
+        {
+            for (int k = 0; k < n; k++)
             {
-                size_t slash = token.find('/');
-                if (slash != std::string::npos)
+                if (done[k]) continue;
+                complex p, dp;
+                double bound;
+                horner_complex(a, z[k], p, dp, bound);
+                if (std::abs(p) <= 4.0 * eps * bound)
                 {
-                    double num = std::stod(token.substr(0, slash));
-                    double den = std::stod(token.substr(slash + 1));
-                    row.push_back(num / den);
+                    done[k] = 1;
+                    remaining--;
+                    continue;
                 }
-                else
+                complex ratio = p / dp;
+                // Σ 1/(z_k - z_j) = Σ conj(d)/|d|², sin la división compleja general
+                double re = 0.0, im = 0.0;
+                for (int j = 0; j < n; j++)
                 {
-                    row.push_back(std::stod(token));
+                    if (j == k) continue;
+                    double dr = z[k].real() - z[j].real(), di = z[k].imag() - z[j].imag();
+                    double inv = 1.0 / (dr * dr + di * di);
+                    re += dr * inv;
+                    im -= di * inv;
                 }
+                z[k] -= ratio / (1.0 - ratio * complex(re, im));
+            }
+        }
+
+        bool finite = std::all_of(z.begin(), z.end(), [](complex v) { return std::isfinite(v.real()) && std::isfinite(v.imag()); });
+        if (remaining > 0 || !finite)
+        {
+            // Matriz compañera (Hessenberg superior): primera fila -a_{n-1}/a_n, ..., -a_0/a_n
+            std::vector<double> companion(n * n, 0.0);
+            for (int j = 0; j < n; j++) companion[j] = -a[n - 1 - j] / a[n];
+            for (int i = 1; i < n; i++) companion[i * n + i - 1] = 1.0;
+            balance(companion, n);
+            std::vector<complex> eigenvalues;
+            if (hessenberg_eigenvalues(companion, n, eigenvalues)) z = eigenvalues;
+            else if (!finite)
+            {
+                std::cerr << "[polynomial_roots] No convergió ni Aberth ni QR\n";
+                return {};
             }
-            if (!row.empty())
-                data.push_back(row);
         }
 
-        rows = static_cast<int>(data.size());
-        columns = rows > 0 ? static_cast<int>(data[0].size()) : 0;
+        roots.insert(roots.end(), z.begin(), z.end());
+        std::sort(roots.begin(), roots.end(), [](complex u, complex v)
+        {
+            return u.real() != v.real() ? u.real() < v.real() : u.imag() < v.imag();
+        });
+        return roots;
     }
 
-    void Matrix::write_to_file(const std::string& filename) const
+    std::vector<std::complex<double>> polynomial_roots(const Function &func, int iterations)
     {
-        std::ofstream file(filename);
-        if (!file.is_open())
+        if (!func.is_polynomial())
         {
-            std::cerr << "[Matrix::write_to_file] No se pudo abrir: "
-                      << filename << "\n";
-            return;
+            std::cerr << "[polynomial_roots] La función no es un polinomio puro\n";
+            return {};
         }
+        return polynomial_roots(func.polynomial_coefficients(), iterations);
+    }
 
-        for (int i = 0; i < rows; i++)
+    // -----------------------------------------------------------------
+    //  parallel_for — cada participante tiene un rango [begin, end)
+    //  protegido por su propio mutex. El dueño toma grain índices del
+    //  frente; un ladrón corta la mitad trasera del rango con más trabajo
+    //  pendiente. Nunca se sostienen dos candados a la vez, así que no hay
+    //  interbloqueo. Un participante termina cuando no encuentra trabajo en
+    //  ningún rango: el trabajo solo disminuye o cambia de dueño, y el que
+    //  lo robó es quien lo ejecuta.
+    //
+    //  Los participantes salen de WorkerPool, un conjunto de hilos que se
+    //  crea en la primera llamada (hardware_threads() - 1 hilos, el que
+    //  llama es el otro) y vive hasta el final del programa; gemm, la LU
+    //  por bloques y solve_batched llaman a parallel_for muchas veces por
+    //  operación y ya no pagan crear y unir hilos en cada una.
+    // -----------------------------------------------------------------
+
+    // hardware_concurrency puede leer /sys en cada llamada (microsegundos,
+    // más que todo un sistema pequeño); se consulta una sola vez
+    static unsigned hardware_threads()
+    {
+        static const unsigned count = std::max(1u, std::thread::hardware_concurrency());
+        return count;
+    }
+
+    struct WorkRange {
+        std::mutex  lock;
+        std::size_t begin = 0;
+        std::size_t end   = 0;
+    };
+
+    // Trabajo publicado en el pool: work(slot) para slot = 1 .. slots-1 (el
+    // slot 0 lo corre quien publica). Los campos se leen y escriben con el
+    // mutex del pool tomado.
+    struct PoolJob {
+        const std::function<void(std::size_t)> *work;
+        std::size_t slots;
+        std::size_t next   = 1;     // siguiente slot por entregar
+        std::size_t active = 0;     // hilos del pool corriendo un slot
+        bool        closed = false; // quien publica ya terminó: no se entregan más
+    };
+
+    class WorkerPool
+    {
+    public:
+        static WorkerPool &instance()
         {
-            for (int j = 0; j < columns; j++)
+            static WorkerPool pool(hardware_threads() - 1);
+            return pool;
+        }
+
+        std::size_t size() const { return workers.size(); }
+
+        // Corre work(0) en este hilo y ofrece los slots 1 .. slots-1 a los
+        // hilos libres del pool. Al volver, ningún hilo del pool sigue
+        // dentro de work. work(0) tiene que poder hacer todo el trabajo por
+        // sí solo (en parallel_for lo hace robando): si el pool está ocupado,
+        // p. ej. con un parallel_for anidado, los slots quedan sin tomar y no
+        // hay espera circular.
+        void run(std::size_t slots, const std::function<void(std::size_t)> &work)
+        {
+            if (workers.empty() || slots <= 1)
             {
-                if (j > 0) file << " ";
-                file << data[i][j];
+                work(0);
+                return;
             }
-            file << "\n";
+
+            PoolJob job{&work, slots};
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                jobs.push_back(&job);
+            }
+            wake.notify_all();
+
+            work(0);
+
+            std::unique_lock<std::mutex> guard(lock);
+            job.closed = true;
+            auto queued = std::find(jobs.begin(), jobs.end(), &job);
+            if (queued != jobs.end()) jobs.erase(queued);
+            finished.wait(guard, [&] { return job.active == 0; });
         }
-    }
 
-    // =====================================================================
+        ~WorkerPool()
+        {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (std::thread &t : workers) t.join();
+        }
 
-    bool evaluate_tolerance(double xn, double xnp1, double tolerance)
+    private:
+        std::mutex               lock;
+        std::condition_variable  wake;
+        std::condition_variable  finished;
+        std::deque<PoolJob *>    jobs;
+        std::vector<std::thread> workers;
+        bool                     stopping = false;
+
+        explicit WorkerPool(std::size_t count)
+        {
+            workers.reserve(count);
+            for (std::size_t w = 0; w < count; w++) workers.emplace_back([this] { serve(); });
+        }
+
+        void serve()
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            while (true)
+            {
+                wake.wait(guard, [&] { return stopping || !jobs.empty(); });
+                if (stopping) return;
+
+                PoolJob *job = jobs.front();
+                std::size_t slot = job->next++;
+                if (job->next == job->slots) jobs.pop_front();
+                job->active++;
+
+                guard.unlock();
+                (*job->work)(slot);
+                guard.lock();
+
+                if (--job->active == 0 && job->closed) finished.notify_all();
+            }
+        }
+    };
+
+    void parallel_for(std::size_t n, const std::function<void(std::size_t, std::size_t)> &body,
+                      int threads, std::size_t grain)
     {
-        double result = (xnp1 - xn) / xnp1;
-        result = std::abs(result);
-        if (result < tolerance) return true;
-        return false;
-    }
+        if (n == 0) return;
+        if (grain == 0) grain = 1;
+        std::size_t workers = threads > 0 ? static_cast<std::size_t>(threads)
+                                          : hardware_threads();
+        workers = std::min(workers, (n + grain - 1) / grain);
+        if (workers <= 1)
+        {
+            body(0, n);
+            return;
+        }
 
-    double bisection(Function func, double point_a, double point_b, double tolerance, int iterations) {
-        double fa;
-        double fb;
-        double p;
-        double fp;
-        for (int i = 0; i < iterations; i++){
-            fa = func.evaluate(point_a);
-            fb = func.evaluate(point_b);
-            p = point_a + ((point_b - point_a) / 2);
-            fp = func.evaluate(p);
-            if (fp == 0 || ((point_b - point_a) / 2) < tolerance) return p;
-            if ( (fa * fp) > 0 ) point_a = p;
-            else point_b = p;
+        std::vector<WorkRange> ranges(workers);
+        for (std::size_t w = 0; w < workers; w++)
+        {
+            ranges[w].begin = n * w / workers;
+            ranges[w].end   = n * (w + 1) / workers;
         }
-        return -1;
+
+        auto work = [&](std::size_t self)
+        {
+            WorkRange &own = ranges[self];
+            while (true)
+            {
+                std::size_t b = 0, e = 0;
+                {
+                    std::lock_guard<std::mutex> guard(own.lock);
+                    if (own.begin < own.end)
+                    {
+                        b = own.begin;
+                        e = std::min(own.end, b + grain);
+                        own.begin = e;
+                    }
+                }
+                if (b < e)
+                {
+                    body(b, e);
+                    continue;
+                }
+
+                // Robo: la víctima es el rango con más índices pendientes
+                std::size_t victim = workers, most = 0;
+                for (std::size_t k = 1; k < workers; k++)
+                {
+                    std::size_t v = (self + k) % workers;
+                    std::lock_guard<std::mutex> guard(ranges[v].lock);
+                    std::size_t left = ranges[v].end - ranges[v].begin;
+                    if (left > most) { most = left; victim = v; }
+                }
+                if (victim == workers) return;
+
+                std::size_t sb = 0, se = 0;
+                {
+                    std::lock_guard<std::mutex> guard(ranges[victim].lock);
+                    std::size_t left = ranges[victim].end - ranges[victim].begin;
+                    if (left == 0) continue;                // alguien se adelantó
+                    se = ranges[victim].end;
+                    sb = ranges[victim].end - (left + 1) / 2;
+                    ranges[victim].end = sb;
+                }
+                std::lock_guard<std::mutex> guard(own.lock);
+                own.begin = sb;
+                own.end   = se;
+            }
+        };
+
+        WorkerPool::instance().run(workers, work);
     }
 
-    double fixed_point(Function func, double initial_point, double tolerance, int iterations) {
-        double point = initial_point;
-        double next_point;
-        double f_next;
-        for (int i = 0; i < iterations; i++){
-            next_point = point - func.evaluate(point);
-            f_next = func.evaluate(next_point);
-            if (f_next == 0 || std::abs(next_point - point) < tolerance) return next_point;
-            point = next_point;
+    RootResult solve_root(const RootProblem &problem)
+    {
+        if (problem.function == nullptr)
+        {
+            std::cerr << "[solve_root] El problema no tiene función\n";
+            return RootResult{};
         }
-        return -1;
+        const Function &f = *problem.function;
+        switch (problem.method)
+        {
+            case RootMethod::Bisection:
+                return bisection(f, problem.point_a, problem.point_b, problem.tolerance, problem.iterations);
+            case RootMethod::FixedPoint:
+                return fixed_point(f, problem.point_a, problem.tolerance, problem.iterations);
+            case RootMethod::FakePosition:
+                return fake_position(f, problem.point_a, problem.point_b, problem.tolerance, problem.iterations);
+            case RootMethod::NewtonRaphson:
+                return newton_raphson(f, problem.point_a, problem.tolerance, problem.iterations);
+            case RootMethod::Secant:
+                return secant_method(f, problem.point_a, problem.point_b, problem.tolerance, problem.iterations);
+            case RootMethod::Halley:
+                return halley_method(f, problem.point_a, problem.tolerance, problem.iterations);
+        }
+        return RootResult{};
     }
 
-    double fake_position(Function func, double point_a, double point_b, double tolerance, int iterations) {
-        double fa;
-        double fb;
-        double p;
-        double fp;
-        for (int i = 0; i < iterations; i++) {
-            fa = func.evaluate(point_a);
-            fb = func.evaluate(point_b);
-            p = ((point_a * fb) - (point_b * fa) ) / (fb - fa);
-            fp = func.evaluate(p);
-            if ( (fp * fa) < 0) {
-                if (NumericalAnalysis::evaluate_tolerance(point_b, p, tolerance)) return p;
-                point_b = p;
-            }
-            else if ( (fp * fb) < 0) {
-                if (NumericalAnalysis::evaluate_tolerance(point_a, p, tolerance)) return p;
-                point_a = p;
-            }
-        }
-        return -1;
+    std::vector<RootResult> solve_roots(const std::vector<RootProblem> &problems, int threads)
+    {
+        std::vector<RootResult> results(problems.size());
+        parallel_for(problems.size(), [&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; i++) results[i] = solve_root(problems[i]);
+        }, threads);
+        return results;
     }
 
-    double newton_raphson(Function func, double initial_point, double tolerance, int iterations){
-        double point = initial_point;
-        double next_point;
-        for (int i = 0; i < iterations; i++){
-            if (std::abs(func.derivate_evaluate(point)) < 1e-12) return -1;
-            next_point = point - (func.evaluate(point) / func.derivate_evaluate(point));
-            if (std::abs(next_point - point) < tolerance) return next_point;
-            point = next_point;
+    ContinuationResult continue_root(const Function &func, const std::string &key, double from, double to,
+                                     double initial_root, const ContinuationOptions &options)
+    {
+        auto start = std::chrono::steady_clock::now();
+        ContinuationResult result;
+        auto finish = [&](RootStatus status)
+        {
+            result.status  = status;
+            result.elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            return result;
+        };
+
+        if (!(options.step > 0.0) || !(options.min_step > 0.0) || options.max_corrections < 1 || !func.contains(key))
+        {
+            std::cerr << "[continue_root] Opciones inválidas o llave \"" << key << "\" inexistente\n";
+            return finish(RootStatus::InvalidInput);
         }
-        return -1;
-    }
 
-    double secant_method(Function func, double point_a, double point_b, double tolerance, int iterations) {
-        // Entendemos como point_a = x(n-1), point_b = x(n) y p = x(n+1)
-        double fa, fb, p;
-        for (int i = 0; i < iterations; i++){
-            fa = func.evaluate(point_a);
-            fb = func.evaluate(point_b);
-            if (std::abs(fb - fa) < 1e-12) return -1;
-            p = ( (point_a * fb) - (point_b * fa) ) / (fb - fa);
-            if (NumericalAnalysis::evaluate_tolerance(point_b, p, tolerance)) return p;
-            point_a = point_b;
-            point_b = p;
+        Function f = func;
+        Function df_dp;                     // ∂f/∂p: el término de key con coeficiente 1
+        df_dp.add(key, 1.0f);
+
+        // update guarda el parámetro como float: la meta es to tal como
+        // queda guardado, o el barrido nunca la alcanza si float(to) < to
+        f.update(key, static_cast<float>(to));
+        const double target = f.get(key);
+
+        f.update(key, static_cast<float>(from));
+        RootResult first = newton_raphson(f, initial_root, options.tolerance, options.iterations);
+        if (!first.converged()) return finish(first.status);
+
+        double p = f.get(key);
+        double x = first.root;
+        result.points.push_back({p, x, first.iterations});
+
+        const double direction = (to >= from) ? 1.0 : -1.0;
+        double h = std::min(options.step, options.max_step);
+        while (direction * (target - p) > 0.0)
+        {
+            // Predictor de segundo orden sobre la rama: de f(x(p), p) = 0,
+            //   f_x x' + f_p = 0,   f_xx x'^2 + 2 f_xp x' + f_x x'' = 0   (f_pp = 0)
+            double d[3], g, dg;
+            f.evaluate_derivatives(x, 2, d);
+            if (std::abs(d[1]) < 1e-12) return finish(RootStatus::ZeroDerivative);
+            df_dp.evaluate_with_derivative(x, g, dg);
+            double slope     = -g / d[1];
+            double curvature = -(d[2] * slope * slope + 2 * dg * slope) / d[1];
+
+            double step     = std::min(h, std::abs(target - p));
+            double p_next   = p + direction * step;
+            f.update(key, static_cast<float>(p_next));
+            p_next          = f.get(key);
+            double dp       = p_next - p;
+            double guess    = x + (slope + 0.5 * curvature * dp) * dp;
+
+            // Corrector
+            RootResult corrected = newton_raphson(f, guess, options.tolerance, options.max_corrections);
+            result.corrections += corrected.iterations;
+            if (!corrected.converged() || std::abs(corrected.root - guess) > options.max_jump || p_next == p)
+            {
+                result.rejected++;
+                f.update(key, static_cast<float>(p));
+                h = step / 2;
+                // Paso agotado. Cerca de un pliegue x ~ x* + c sqrt(p* - p) y
+                // la distancia a él es |x'| / (2 |x''|); si cae a menos de
+                // dos pasos, la rama da la vuelta ahí
+                if (h < options.min_step)
+                    return finish(std::abs(slope) < 4 * std::abs(curvature * dp) ? RootStatus::ZeroDerivative
+                                  : corrected.converged() ? RootStatus::MaxIterations : corrected.status);
+                continue;
+            }
+
+            p = p_next;
+            x = corrected.root;
+            result.points.push_back({p, x, corrected.iterations});
+            if (corrected.iterations <= options.fast_corrections) h = std::min(step * options.growth, options.max_step);
+            else                                                  h = std::max(step / options.growth, options.min_step);
         }
-        return -1;
+        return finish(RootStatus::Converged);
     }
 
     // =====================================================================
@@ -796,7 +3475,7 @@ namespace NumericalAnalysis
     //      x_i = (c_i - suma) / r_ii
     // -----------------------------------------------------------------
 
-    Matrix regressive_substitution(Matrix matrix)
+    Matrix regressive_substitution(ConstMatrixView matrix)
     {
         int n = matrix.getRows();
         Matrix x(n, 1);
@@ -808,29 +3487,34 @@ namespace NumericalAnalysis
                       << n << "x" << matrix.getCols() << "\n";
             return x;
         }
+        if (n == 0)
+        {
+            std::cerr << "[regressive_substitution] La matriz está vacía, no hay sistema que resolver\n";
+            return Matrix();
+        }
 
-        double rnn = matrix.get(n - 1, n - 1);
+        double rnn = matrix(n - 1, n - 1);
         if (std::abs(rnn) < 1e-12)
         {
             std::cerr << "[regressive_substitution] r_nn = 0, no se puede resolver\n";
             return x;
         }
-        x.set(n - 1, 0, matrix.get(n - 1, n) / rnn);
+        x(n - 1, 0) = matrix(n - 1, n) / rnn;
 
         for (int i = n - 2; i >= 0; i--)
         {
             double sum = 0.0;
             for (int j = i + 1; j < n; j++)
-                sum += matrix.get(i, j) * x.get(j, 0);
+                sum += matrix(i, j) * x(j, 0);
 
-            double rii = matrix.get(i, i);
+            double rii = matrix(i, i);
             if (std::abs(rii) < 1e-12)
             {
                 std::cerr << "[regressive_substitution] r_" << i+1 << i+1
                           << " = 0, no se puede resolver\n";
                 return x;
             }
-            x.set(i, 0, (matrix.get(i, n) - sum) / rii);
+            x(i, 0) = (matrix(i, n) - sum) / rii;
         }
 
         return x;
@@ -843,8 +3527,9 @@ namespace NumericalAnalysis
     //  Retorna la matriz en forma escalonada (triangular superior).
     // -----------------------------------------------------------------
 
-    Matrix gaussian_elimination_step(Matrix matrix)
+    Matrix gaussian_elimination_step(ConstMatrixView input)
     {
+        Matrix matrix = input;
         int n = matrix.getRows();
         int cols = matrix.getCols();
 
@@ -853,7 +3538,7 @@ namespace NumericalAnalysis
             int p = -1;
             for (int k = i; k < n; k++)
             {
-                if (std::abs(matrix.get(k, i)) > 1e-12)
+                if (std::abs(matrix(k, i)) > 1e-12)
                 {
                     p = k;
                     break;
@@ -863,20 +3548,15 @@ namespace NumericalAnalysis
             if (p == -1) continue;
 
             if (p != i)
-            {
-                for (int j = 0; j < cols; j++)
-                {
-                    double temp = matrix.get(i, j);
-                    matrix.set(i, j, matrix.get(p, j));
-                    matrix.set(p, j, temp);
-                }
-            }
+                std::swap_ranges(matrix.row(i), matrix.row(i) + cols, matrix.row(p));
 
+            const double *ri = matrix.row(i);
             for (int j = i + 1; j < n; j++)
             {
-                double mji = matrix.get(j, i) / matrix.get(i, i);
+                double *rj  = matrix.row(j);
+                double  mji = rj[i] / ri[i];
                 for (int k = i; k < cols; k++)
-                    matrix.set(j, k, matrix.get(j, k) - mji * matrix.get(i, k));
+                    rj[k] -= mji * ri[k];
             }
         }
 
@@ -890,17 +3570,24 @@ namespace NumericalAnalysis
     //  Salida:  Vector solución x como Matrix de n×1.
     // -----------------------------------------------------------------
 
-    Matrix gaussian_elimination_with_regressive_substitution(Matrix matrix)
+    Matrix gaussian_elimination_with_regressive_substitution(ConstMatrixView input)
     {
-        int n = matrix.getRows();
+        int n = input.getRows();
 
-        if (matrix.getCols() != n + 1)
+        if (input.getCols() != n + 1)
         {
             std::cerr << "[gaussian_elimination] La matriz debe ser aumentada "
                       << n << "x" << (n + 1) << ", se recibió "
-                      << n << "x" << matrix.getCols() << "\n";
+                      << n << "x" << input.getCols() << "\n";
             return Matrix(n, 1);
         }
+        if (n == 0)
+        {
+            std::cerr << "[gaussian_elimination] La matriz está vacía, no hay sistema que resolver\n";
+            return Matrix();
+        }
+
+        Matrix matrix = input;
 
         for (int i = 0; i < n - 1; i++)
         {
@@ -908,7 +3595,7 @@ namespace NumericalAnalysis
             int p = -1;
             for (int k = i; k < n; k++)
             {
-                if (std::abs(matrix.get(k, i)) > 1e-12)
+                if (std::abs(matrix(k, i)) > 1e-12)
                 {
                     p = k;
                     break;
@@ -923,25 +3610,20 @@ namespace NumericalAnalysis
 
             // Intercambio de filas si p ≠ i
             if (p != i)
-            {
-                for (int j = 0; j <= n; j++)
-                {
-                    double temp = matrix.get(i, j);
-                    matrix.set(i, j, matrix.get(p, j));
-                    matrix.set(p, j, temp);
-                }
-            }
+                std::swap_ranges(matrix.row(i), matrix.row(i) + n + 1, matrix.row(p));
 
             // Eliminación: E_j ← E_j - m_ji * E_i
+            const double *ri = matrix.row(i);
             for (int j = i + 1; j < n; j++)
             {
-                double mji = matrix.get(j, i) / matrix.get(i, i);
+                double *rj  = matrix.row(j);
+                double  mji = rj[i] / ri[i];
                 for (int k = i; k <= n; k++)
-                    matrix.set(j, k, matrix.get(j, k) - mji * matrix.get(i, k));
+                    rj[k] -= mji * ri[k];
             }
         }
 
-        if (std::abs(matrix.get(n - 1, n - 1)) < 1e-12)
+        if (std::abs(matrix(n - 1, n - 1)) < 1e-12)
         {
             std::cerr << "[gaussian_elimination] No existe solución única (a_nn = 0)\n";
             return Matrix(n, 1);
@@ -950,6 +3632,167 @@ namespace NumericalAnalysis
         return regressive_substitution(matrix);
     }
 
+    // -----------------------------------------------------------------
+    //  Sistemas por lotes (SoA)
+    //
+    //  Cada tarea copia BATCH_LANES sistemas a un bloque local con el
+    //  mismo formato intercalado (cabe en L1 para n pequeño) y corre la
+    //  eliminación de gaussian_elimination_with_regressive_substitution
+    //  con un bucle interno sobre los carriles de largo fijo, que el
+    //  compilador vectoriza. Las decisiones que dependen del sistema
+    //  (qué fila es el pivote, si falló) se toman por carril con
+    //  selecciones en vez de saltos. El último bloque se rellena con
+    //  identidades para no romper el largo fijo.
+    // -----------------------------------------------------------------
+
+    static constexpr int BATCH_LANES = 64;
+
+    // Bucles sobre carriles entre dos filas del mismo bloque; __restrict
+    // le asegura al compilador que no se solapan y así los vectoriza sin
+    // comprobaciones en tiempo de ejecución
+    static inline void lanes_swap_where(double *__restrict a, double *__restrict b, const double *__restrict take)
+    {
+        for (int l = 0; l < BATCH_LANES; l++)
+        {
+            const double u = a[l], v = b[l];
+            const double first  = take[l] != 0.0 ? v : u;     // las dos selecciones antes de
+            const double second = take[l] != 0.0 ? u : v;     // guardar: GCC no vectoriza si no
+            a[l] = first;
+            b[l] = second;
+        }
+    }
+
+    static inline void lanes_subtract_scaled(double *__restrict y, const double *__restrict factor, const double *__restrict x)
+    {
+        for (int l = 0; l < BATCH_LANES; l++) y[l] -= factor[l] * x[l];
+    }
+
+    // block: n×(n+1) filas de BATCH_LANES carriles; x: n filas de BATCH_LANES.
+    // bad[l] queda en 1 si el sistema del carril l no tiene solución única.
+    static void batched_elimination(int n, double *__restrict block, double *__restrict x, unsigned char *bad)
+    {
+        constexpr int L = BATCH_LANES;
+        const int cols = n + 1;
+        auto at = [&](int i, int j) { return block + (static_cast<std::size_t>(i) * cols + j) * L; };
+
+        alignas(64) double factor[L];
+        alignas(64) double take[L];
+        alignas(64) double failed[L] = {};
+
+        for (int i = 0; i < n - 1; i++)
+        {
+            // Menor p ≥ i con |a_pi| > 1e-12: al recorrer p en orden, un
+            // carril toma la fila p solo si todavía no tiene pivote. Si
+            // ningún carril la toma (lo normal) no se mueve nada.
+            for (int p = i + 1; p < n; p++)
+            {
+                const double *aii = at(i, i), *api = at(p, i);
+                for (int l = 0; l < L; l++)
+                    take[l] = (!(std::abs(aii[l]) > 1e-12)) & (std::abs(api[l]) > 1e-12) ? 1.0 : 0.0;
+                double takers = 0.0;
+                for (int l = 0; l < L; l++) takers += take[l];
+                if (takers == 0.0) continue;
+                for (int j = i; j < cols; j++) lanes_swap_where(at(i, j), at(p, j), take);
+            }
+            const double *pivot = at(i, i);
+            for (int l = 0; l < L; l++)
+                failed[l] = std::abs(pivot[l]) > 1e-12 ? failed[l] : 1.0;
+
+            // E_j ← E_j - m_ji * E_i (la columna i ya no se vuelve a leer)
+            for (int j = i + 1; j < n; j++)
+            {
+                const double *aji = at(j, i);
+                for (int l = 0; l < L; l++) factor[l] = aji[l] / pivot[l];
+                for (int k = i + 1; k < cols; k++) lanes_subtract_scaled(at(j, k), factor, at(i, k));
+            }
+        }
+
+        // Sustitución regresiva, con las mismas comprobaciones de r_ii
+        for (int i = n - 1; i >= 0; i--)
+        {
+            double       *xi  = x + static_cast<std::size_t>(i) * L;
+            const double *rii = at(i, i), *ci = at(i, n);
+            for (int l = 0; l < L; l++) factor[l] = 0.0;
+            for (int j = i + 1; j < n; j++)
+            {
+                const double *rij = at(i, j), *xj = x + static_cast<std::size_t>(j) * L;
+                for (int l = 0; l < L; l++) factor[l] += rij[l] * xj[l];
+            }
+            for (int l = 0; l < L; l++)
+            {
+                failed[l] = std::abs(rii[l]) < 1e-12 ? 1.0 : failed[l];
+                xi[l]     = (ci[l] - factor[l]) / rii[l];
+            }
+        }
+        for (int l = 0; l < L; l++) bad[l] = failed[l] != 0.0;
+    }
+
+    int solve_batched(int n, std::size_t count, const double *augmented, double *solutions,
+                      unsigned char *singular, int threads)
+    {
+        if (n <= 0)
+        {
+            std::cerr << "[solve_batched] n debe ser positivo\n";
+            return 0;
+        }
+        constexpr int L = BATCH_LANES;
+        const int cols = n + 1;
+        const std::size_t elements = static_cast<std::size_t>(n) * cols;
+        const std::size_t blocks   = (count + L - 1) / L;
+
+        std::atomic<int> failures{0};
+        parallel_for(blocks, [&](std::size_t begin, std::size_t end)
+        {
+            AlignedBuffer block(elements * L), x(static_cast<std::size_t>(n) * L);
+            alignas(64) unsigned char bad[L];
+
+            for (std::size_t b = begin; b < end; b++)
+            {
+                const std::size_t k0 = b * L;
+                const int w = static_cast<int>(std::min<std::size_t>(L, count - k0));
+                for (std::size_t e = 0; e < elements; e++)
+                {
+                    double *dst = block.data() + e * L;
+                    std::copy_n(augmented + e * count + k0, w, dst);
+                    const bool diagonal = e % cols == e / cols;
+                    std::fill(dst + w, dst + L, diagonal ? 1.0 : 0.0);
+                }
+
+                batched_elimination(n, block.data(), x.data(), bad);
+
+                int failed = 0;
+                for (int i = 0; i < n; i++)
+                {
+                    double *out = solutions + static_cast<std::size_t>(i) * count + k0;
+                    const double *xi = x.data() + static_cast<std::size_t>(i) * L;
+                    for (int l = 0; l < w; l++) out[l] = bad[l] ? 0.0 : xi[l];
+                }
+                for (int l = 0; l < w; l++) failed += bad[l];
+                if (singular) std::copy_n(bad, w, singular + k0);
+                if (failed) failures += failed;
+            }
+        }, threads);
+
+        if (failures > 0)
+            std::cerr << "[solve_batched] " << failures << " de " << count
+                      << " sistemas sin solución única (x = 0)\n";
+        return failures;
+    }
+
+    std::vector<double> solve_batched(int n, std::size_t count, const std::vector<double> &augmented, int threads)
+    {
+        const std::size_t expected = static_cast<std::size_t>(std::max(n, 0)) * (n + 1) * count;
+        if (n <= 0 || augmented.size() != expected)
+        {
+            std::cerr << "[solve_batched] Se esperaban " << expected << " valores, se recibieron "
+                      << augmented.size() << "\n";
+            return std::vector<double>(static_cast<std::size_t>(std::max(n, 0)) * count, 0.0);
+        }
+        std::vector<double> solutions(static_cast<std::size_t>(n) * count);
+        solve_batched(n, count, augmented.data(), solutions.data(), nullptr, threads);
+        return solutions;
+    }
+
     // -----------------------------------------------------------------
     //  Factorización LU con pivoteo parcial — PA = LU
     //
@@ -957,7 +3800,7 @@ namespace NumericalAnalysis
     //  Salida:  Matrices L y U tales que PA = LU.
     // -----------------------------------------------------------------
 
-    void lu_factorization(Matrix A, Matrix& L, Matrix& U)
+    void lu_factorization(ConstMatrixView A, Matrix& L, Matrix& U)
     {
         int n = A.getRows();
 
@@ -969,59 +3812,192 @@ namespace NumericalAnalysis
             return;
         }
 
-        Matrix work(n, n);
-        for (int i = 0; i < n; i++)
-            for (int j = 0; j < n; j++)
-                work.set(i, j, A.get(i, j));
+        LUDecomposition lu(A);
+        if (lu.singular())
+        {
+            std::cerr << "[lu_factorization] Matriz singular, no se puede factorizar\n";
+            L = Matrix(); U = Matrix();
+            return;
+        }
+        L = lu.lower();
+        U = lu.upper();
+    }
 
-        for (int j = 0; j < n; j++)
+    // -----------------------------------------------------------------
+    //  Núcleo LU, compartido por lu_factorization, lu_substitution y los
+    //  métodos para sistemas no lineales.
+    //
+    //  a es n×n por filas con stride lda. Al salir guarda L (bajo la
+    //  diagonal, con unos implícitos) y U (diagonal y arriba) de PA = LU;
+    //  pivots[j] es la fila que se intercambió con la j en el paso j.
+    //  Pivoteo parcial por el máximo |a_ij| de la columna; false si el
+    //  pivote cae bajo 1e-12. Factorizar cuesta O(n³); cada lu_solve
+    //  después es O(n²), así que un mismo factor se reutiliza para muchos
+    //  lados derechos.
+    //
+    //  Por bloques, hacia la derecha, con paneles de LU_BLOCK columnas:
+    //    1. el panel [j0, j0+jb) se factoriza sin bloques (lu_panel);
+    //       sus intercambios solo tocan las columnas del panel
+    //    2. el resto de columnas recibe los intercambios, U12 = L11^{-1} A12
+    //       y A22 -= L21 U12 con gemm (lu_update_columns)
+    //  El paso 2 se reparte por bloques de columnas con parallel_for. La
+    //  tarea 0 es el siguiente panel: se actualiza primero y se factoriza
+    //  mientras las demás siguen con el resto de la matriz (lookahead), así
+    //  la factorización del panel, que es secuencial, no deja hilos ociosos.
+    // -----------------------------------------------------------------
+
+    static constexpr int LU_BLOCK = 128;
+
+    // Factoriza sin bloques las filas [j0, n) del panel de columnas [j0, j0+jb)
+    static bool lu_panel(double *a, int n, int lda, int j0, int jb, int *pivots)
+    {
+        for (int j = j0; j < j0 + jb; j++)
         {
             int r = j;
-            double maxVal = std::abs(work.get(j, j));
+            double maxVal = std::abs(a[static_cast<std::size_t>(j) * lda + j]);
             for (int i = j + 1; i < n; i++)
             {
-                double val = std::abs(work.get(i, j));
+                double val = std::abs(a[static_cast<std::size_t>(i) * lda + j]);
                 if (val > maxVal) { maxVal = val; r = i; }
             }
+            pivots[j] = r;
+            if (maxVal < 1e-12) return false;
+
+            double *row_j = a + static_cast<std::size_t>(j) * lda;
+            if (r != j)
+                std::swap_ranges(row_j + j0, row_j + j0 + jb, a + static_cast<std::size_t>(r) * lda + j0);
 
-            if (maxVal < 1e-12)
+            for (int i = j + 1; i < n; i++)
             {
-                std::cerr << "[lu_factorization] Matriz singular, no se puede factorizar\n";
-                L = Matrix(); U = Matrix();
-                return;
+                double *row_i = a + static_cast<std::size_t>(i) * lda;
+                double mij = row_i[j] / row_j[j];
+                row_i[j] = mij;
+                for (int k = j + 1; k < j0 + jb; k++)
+                    row_i[k] -= mij * row_j[k];
             }
+        }
+        return true;
+    }
 
-            if (r != j)
+    // Intercambios pivots[j0 .. j0+jb) sobre las columnas [c0, c1)
+    static void lu_apply_swaps(double *a, int lda, int j0, int jb, const int *pivots, int c0, int c1)
+    {
+        for (int j = j0; j < j0 + jb; j++)
+            if (pivots[j] != j)
+                std::swap_ranges(a + static_cast<std::size_t>(j) * lda + c0, a + static_cast<std::size_t>(j) * lda + c1,
+                                 a + static_cast<std::size_t>(pivots[j]) * lda + c0);
+    }
+
+    // Columnas [c0, c1) a la derecha del panel [j0, j0+jb)
+    static void lu_update_columns(double *a, int n, int lda, int j0, int jb, const int *pivots, int c0, int c1)
+    {
+        lu_apply_swaps(a, lda, j0, jb, pivots, c0, c1);
+
+        // U12 = L11^{-1} A12, L11 triangular inferior con unos en la diagonal
+        const int width = c1 - c0;
+        for (int i = j0 + 1; i < j0 + jb; i++)
+        {
+            const double *l     = a + static_cast<std::size_t>(i) * lda;
+            double       *row_i = a + static_cast<std::size_t>(i) * lda + c0;
+            for (int k = j0; k < i; k++)
             {
-                for (int k = 0; k < n; k++)
-                {
-                    double temp = work.get(j, k);
-                    work.set(j, k, work.get(r, k));
-                    work.set(r, k, temp);
-                }
+                const double  lik   = l[k];
+                const double *row_k = a + static_cast<std::size_t>(k) * lda + c0;
+                for (int c = 0; c < width; c++) row_i[c] -= lik * row_k[c];
             }
+        }
 
-            for (int i = j + 1; i < n; i++)
+        // A22 -= L21 U12
+        const int below = n - (j0 + jb);
+        if (below > 0)
+            gemm(below, width, jb, -1.0,
+                 a + static_cast<std::size_t>(j0 + jb) * lda + j0, lda,
+                 a + static_cast<std::size_t>(j0) * lda + c0,      lda, 1.0,
+                 a + static_cast<std::size_t>(j0 + jb) * lda + c0, lda, 1);
+    }
+
+    bool lu_decompose(double *a, int n, int lda, std::vector<int> &pivots, int threads)
+    {
+        pivots.resize(n);
+        if (n <= 0) return true;
+        if (!lu_panel(a, n, lda, 0, std::min(LU_BLOCK, n), pivots.data())) return false;
+
+        const int workers = threads > 0 ? threads : static_cast<int>(hardware_threads());
+        for (int j0 = 0; j0 < n; j0 += LU_BLOCK)
+        {
+            const int jb      = std::min(LU_BLOCK, n - j0);
+            const int next    = j0 + jb;                        // siguiente panel (lookahead)
+            const int next_jb = std::min(LU_BLOCK, n - next);   // 0 en el último paso
+            const int rest    = next + next_jb;
+
+            // Bloques de columnas: unos 2 por hilo a la derecha, 1 por hilo a la izquierda
+            const int right       = n - rest;
+            const int right_width = std::max(LU_BLOCK, (right + 2 * workers - 1) / (2 * workers));
+            const int right_tasks = (right + right_width - 1) / right_width;
+            const int left_width  = std::max(LU_BLOCK, (j0 + workers - 1) / workers);
+            const int left_tasks  = (j0 + left_width - 1) / left_width;
+
+            bool singular = false;      // solo lo escribe la tarea 0
+            parallel_for(static_cast<std::size_t>(1 + right_tasks + left_tasks), [&](std::size_t begin, std::size_t end)
             {
-                double mij = work.get(i, j) / work.get(j, j);
-                work.set(i, j, mij);
-                for (int k = j + 1; k < n; k++)
-                    work.set(i, k, work.get(i, k) - mij * work.get(j, k));
-            }
+                for (std::size_t task = begin; task < end; task++)
+                {
+                    const int t = static_cast<int>(task);
+                    if (t == 0)
+                    {
+                        if (next_jb == 0) continue;
+                        lu_update_columns(a, n, lda, j0, jb, pivots.data(), next, rest);
+                        singular = !lu_panel(a, n, lda, next, next_jb, pivots.data());
+                    }
+                    else if (t <= right_tasks)
+                    {
+                        const int c0 = rest + (t - 1) * right_width;
+                        lu_update_columns(a, n, lda, j0, jb, pivots.data(), c0, std::min(n, c0 + right_width));
+                    }
+                    else
+                    {
+                        const int c0 = (t - 1 - right_tasks) * left_width;
+                        lu_apply_swaps(a, lda, j0, jb, pivots.data(), c0, std::min(j0, c0 + left_width));
+                    }
+                }
+            }, threads);
+            if (singular) return false;
         }
+        return true;
+    }
 
-        L = Matrix(n, n);
-        U = Matrix(n, n);
-        for (int i = 0; i < n; i++)
+    bool lu_decompose(std::vector<double> &a, int n, std::vector<int> &pivots)
+    {
+        return lu_decompose(a.data(), n, n, pivots);
+    }
+
+    // b <- A^{-1} b con el factor de lu_decompose: Pb, luego Ly = Pb y Ux = y
+    void lu_solve(const double *lu, int n, int lda, const std::vector<int> &pivots, double *b)
+    {
+        for (int j = 0; j < n; j++)
+            if (pivots[j] != j) std::swap(b[j], b[pivots[j]]);
+
+        for (int i = 1; i < n; i++)
+        {
+            const double *row = lu + static_cast<std::size_t>(i) * lda;
+            double acc = b[i];
+            for (int k = 0; k < i; k++) acc -= row[k] * b[k];
+            b[i] = acc;
+        }
+        for (int i = n - 1; i >= 0; i--)
         {
-            L.set(i, i, 1.0);
-            for (int j = 0; j < i; j++)
-                L.set(i, j, work.get(i, j));
-            for (int j = i; j < n; j++)
-                U.set(i, j, work.get(i, j));
+            const double *row = lu + static_cast<std::size_t>(i) * lda;
+            double acc = b[i];
+            for (int k = i + 1; k < n; k++) acc -= row[k] * b[k];
+            b[i] = acc / row[i];
         }
     }
 
+    void lu_solve(const std::vector<double> &lu, int n, const std::vector<int> &pivots, double *b)
+    {
+        lu_solve(lu.data(), n, n, pivots, b);
+    }
+
     // -----------------------------------------------------------------
     //  Sustitución LU — Resuelve Ax = b usando PA = LU (Tarea 3)
     //
@@ -1029,7 +4005,7 @@ namespace NumericalAnalysis
     //  Salida:  Vector solución x como Matrix de n×1.
     // -----------------------------------------------------------------
 
-    Matrix lu_substitution(Matrix matrix)
+    Matrix lu_substitution(ConstMatrixView matrix)
     {
         int n = matrix.getRows();
 
@@ -1041,71 +4017,161 @@ namespace NumericalAnalysis
             return Matrix(n, 1);
         }
 
-        std::vector<int> perm(n);
-        for (int i = 0; i < n; i++) perm[i] = i;
-
-        for (int j = 0; j < n; j++)
+        // A y b son vistas de [A|b]: solo se copian al factor y a la solución
+        LUDecomposition lu(matrix.block(0, 0, n, n));
+        if (lu.singular())
         {
-            // 2.1 Pivoteo parcial: buscar r con |a_rj| máximo
-            int r = j;
-            double maxVal = std::abs(matrix.get(j, j));
-            for (int i = j + 1; i < n; i++)
-            {
-                double val = std::abs(matrix.get(i, j));
-                if (val > maxVal)
-                {
-                    maxVal = val;
-                    r = i;
-                }
-            }
+            std::cerr << "[lu_substitution] Matriz singular, no se puede factorizar\n";
+            return Matrix(n, 1);
+        }
+        return lu.solve(matrix.column_view(n));
+    }
 
-            // 2.2 Chequeo de singularidad
-            if (maxVal < 1e-12)
-            {
-                std::cerr << "[lu_substitution] Matriz singular, no se puede factorizar\n";
-                return Matrix(n, 1);
-            }
+    // -----------------------------------------------------------------
+    //  LUDecomposition
+    // -----------------------------------------------------------------
 
-            // 2.3 Intercambio de filas
-            if (r != j)
-            {
-                std::swap(perm[j], perm[r]);
-                for (int k = 0; k <= n; k++)
-                {
-                    double temp = matrix.get(j, k);
-                    matrix.set(j, k, matrix.get(r, k));
-                    matrix.set(r, k, temp);
-                }
-            }
+    LUDecomposition::LUDecomposition() {}
 
-            // 2.4 Eliminación
-            for (int i = j + 1; i < n; i++)
-            {
-                double mij = matrix.get(i, j) / matrix.get(j, j);
-                matrix.set(i, j, mij);
-                matrix.set(i, n, matrix.get(i, n) - mij * matrix.get(j, n));
-                for (int k = j + 1; k < n; k++)
-                    matrix.set(i, k, matrix.get(i, k) - mij * matrix.get(j, k));
-            }
+    LUDecomposition::LUDecomposition(ConstMatrixView A, int threads)
+    {
+        if (A.getRows() != A.getCols())
+        {
+            std::cerr << "[LUDecomposition] Se esperaba una matriz cuadrada, se recibió "
+                      << A.getRows() << "x" << A.getCols() << "\n";
+            return;
         }
+        lu = A;
+        failed = !lu_decompose(lu.data(), lu.getRows(), lu.stride(), pivots, threads);
+    }
 
-        // 3. Chequeo final
-        if (std::abs(matrix.get(n - 1, n - 1)) < 1e-12)
+    bool LUDecomposition::singular() const { return failed; }
+    int  LUDecomposition::size() const { return lu.getRows(); }
+    const std::vector<int> &LUDecomposition::permutation() const { return pivots; }
+
+    Matrix LUDecomposition::lower() const
+    {
+        int n = size();
+        Matrix L(n, n);
+        for (int i = 0; i < n; i++)
         {
-            std::cerr << "[lu_substitution] Matriz singular (a_nn = 0)\n";
-            return Matrix(n, 1);
+            std::copy_n(lu.row(i), i, L.row(i));
+            L(i, i) = 1.0;
         }
+        return L;
+    }
 
-        // 5. Resolver Ux = b_modificado con sustitución regresiva
-        Matrix upper(n, n + 1);
+    Matrix LUDecomposition::upper() const
+    {
+        int n = size();
+        Matrix U(n, n);
         for (int i = 0; i < n; i++)
+            std::copy(lu.row(i) + i, lu.row(i) + n, U.row(i) + i);
+        return U;
+    }
+
+    void LUDecomposition::solve_in_place(double *b) const
+    {
+        if (failed)
+        {
+            std::cerr << "[LUDecomposition::solve] Matriz singular, no se puede resolver\n";
+            std::fill_n(b, size(), 0.0);
+            return;
+        }
+        lu_solve(lu.data(), size(), lu.stride(), pivots, b);
+    }
+
+    std::vector<double> LUDecomposition::solve(const std::vector<double> &b) const
+    {
+        if (static_cast<int>(b.size()) != size())
+        {
+            std::cerr << "[LUDecomposition::solve] b tiene " << b.size()
+                      << " entradas, se esperaban " << size() << "\n";
+            return std::vector<double>(size(), 0.0);
+        }
+        std::vector<double> x = b;
+        solve_in_place(x.data());
+        return x;
+    }
+
+    // Todas las columnas a la vez: cada fila de X se actualiza con filas
+    // completas (contiguas) de X, así el bucle interno recorre las k
+    // columnas seguidas. Bloques de columnas de X van a hilos distintos.
+    Matrix LUDecomposition::solve(ConstMatrixView B, int threads) const
+    {
+        const int n = size();
+        const int k = B.getCols();
+        if (B.getRows() != n)
+        {
+            std::cerr << "[LUDecomposition::solve] B tiene " << B.getRows()
+                      << " filas, se esperaban " << n << "\n";
+            return Matrix(n, k);
+        }
+        if (failed)
+        {
+            std::cerr << "[LUDecomposition::solve] Matriz singular, no se puede resolver\n";
+            return Matrix(n, k);
+        }
+
+        Matrix X = B;
+        for (int j = 0; j < n; j++)
+            if (pivots[j] != j) std::swap_ranges(X.row(j), X.row(j) + k, X.row(pivots[j]));
+
+        constexpr int COLUMN_BLOCK = 256;
+        const std::size_t blocks = static_cast<std::size_t>((k + COLUMN_BLOCK - 1) / COLUMN_BLOCK);
+        parallel_for(blocks, [&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t block = begin; block < end; block++)
+            {
+                const int c0 = static_cast<int>(block) * COLUMN_BLOCK;
+                const int w  = std::min(COLUMN_BLOCK, k - c0);
+
+                for (int i = 1; i < n; i++)                 // L y = P b
+                {
+                    const double *l  = lu.row(i);
+                    double       *xi = X.row(i) + c0;
+                    for (int p = 0; p < i; p++)
+                    {
+                        const double  lip = l[p];
+                        const double *xp  = X.row(p) + c0;
+                        for (int c = 0; c < w; c++) xi[c] -= lip * xp[c];
+                    }
+                }
+                for (int i = n - 1; i >= 0; i--)            // U x = y
+                {
+                    const double *u  = lu.row(i);
+                    double       *xi = X.row(i) + c0;
+                    for (int p = i + 1; p < n; p++)
+                    {
+                        const double  uip = u[p];
+                        const double *xp  = X.row(p) + c0;
+                        for (int c = 0; c < w; c++) xi[c] -= uip * xp[c];
+                    }
+                    for (int c = 0; c < w; c++) xi[c] /= u[i];
+                }
+            }
+        }, threads);
+        return X;
+    }
+
+    double LUDecomposition::determinant() const
+    {
+        if (failed) return 0.0;
+        double det = 1.0;
+        for (int j = 0; j < size(); j++)
         {
-            for (int jj = i; jj < n; jj++)
-                upper.set(i, jj, matrix.get(i, jj));
-            upper.set(i, n, matrix.get(i, n));
+            det *= lu(j, j);
+            if (pivots[j] != j) det = -det;
         }
+        return det;
+    }
 
-        return regressive_substitution(upper);
+    Matrix LUDecomposition::inverse(int threads) const
+    {
+        int n = size();
+        Matrix identity(n, n);
+        for (int i = 0; i < n; i++) identity(i, i) = 1.0;
+        return solve(identity, threads);
     }
 
     // -----------------------------------------------------------------
@@ -1130,7 +4196,7 @@ namespace NumericalAnalysis
     //  dominante sobre filas: |a_ii| > Σ_{j≠i} |a_ij|
     // -----------------------------------------------------------------
 
-    Matrix gauss_seidel(Matrix matrix, Matrix initial, double tolerance, int iterations)
+    Matrix gauss_seidel(ConstMatrixView matrix, ConstMatrixView initial, double tolerance, int iterations)
     {
         int n = matrix.getRows();
 
@@ -1141,13 +4207,16 @@ namespace NumericalAnalysis
                       << n << "x" << matrix.getCols() << "\n";
             return Matrix(n, 1);
         }
+        if (initial.getRows() != n || initial.getCols() < 1)
+        {
+            std::cerr << "[gauss_seidel] El vector inicial debe ser " << n << "x1, se recibió "
+                      << initial.getRows() << "x" << initial.getCols() << "\n";
+            return Matrix(n, 1);
+        }
 
-        Matrix x0(n, 1);
+        Matrix x0 = initial.column_view(0);
         Matrix x(n, 1);
 
-        for (int i = 0; i < n; i++)
-            x0.set(i, 0, initial.get(i, 0));
-
         std::cout << "\n--- Iteraciones de Gauss-Seidel ---\n";
         std::cout << std::fixed << std::setprecision(8);
 
@@ -1156,22 +4225,19 @@ namespace NumericalAnalysis
             for (int i = 0; i < n; i++)
             {
                 double sum = 0.0;
-                for (int j = 0; j < n; j++)
-                {
-                    if (j < i)
-                        sum += matrix.get(i, j) * x.get(j, 0);
-                    else if (j > i)
-                        sum += matrix.get(i, j) * x0.get(j, 0);
-                }
+                for (int j = 0; j < i; j++)
+                    sum += matrix(i, j) * x(j, 0);
+                for (int j = i + 1; j < n; j++)
+                    sum += matrix(i, j) * x0(j, 0);
 
-                double aii = matrix.get(i, i);
+                double aii = matrix(i, i);
                 if (std::abs(aii) < 1e-12)
                 {
                     std::cerr << "[gauss_seidel] a_" << i+1 << i+1
                               << " = 0, no se puede resolver\n";
                     return x;
                 }
-                x.set(i, 0, (matrix.get(i, n) - sum) / aii);
+                x(i, 0) = (matrix(i, n) - sum) / aii;
             }
 
             double norm = 0.0;
@@ -1203,69 +4269,4 @@ namespace NumericalAnalysis
                   << iterations << ")\n";
         return x;
     }
-
-    double inferior_sums(Function func, double a, double b, int n)
-    {
-        double dx = (b - a) / n;
-        double sum = 0.0;
-
-        for (int i = 1; i <= n; i++)
-        {
-            double f_prev = func.evaluate(a + (i - 1) * dx);
-            double f_curr = func.evaluate(a + i * dx);
-            sum += std::min(f_prev, f_curr) * dx;
-        }
-
-        return sum;
-    }
-
-    double superior_sums(Function func, double a, double b, int n)
-    {
-        double dx = (b - a) / n;
-        double sum = 0.0;
-
-        for (int i = 1; i <= n; i++)
-        {
-            double f_prev = func.evaluate(a + (i - 1) * dx);
-            double f_curr = func.evaluate(a + i * dx);
-            sum += std::max(f_prev, f_curr) * dx;
-        }
-
-        return sum;
-    }
-
-    double trapezoidal_rule(Function func, double a, double b, int n)
-    {
-        double h = (b - a) / n;
-        double s0 = func.evaluate(a) + func.evaluate(b);
-        double s1 = 0.0;
-
-        for (int i = 1; i < n; i++)
-            s1 += func.evaluate(a + i * h);
-
-        return (h / 2.0) * (s0 + 2.0 * s1);
-    }
-
-    double simpson_rule(Function func, double a, double b, int n)
-    {
-        if (n <= 0 || n % 2 != 0)
-        {
-            std::cerr << "[simpson_rule] n debe ser un entero positivo par\n";
-            return -1;
-        }
-
-        double h = (b - a) / n;
-        double s0 = func.evaluate(a) + func.evaluate(b);
-        double s1 = 0.0; // Terminos con indice impar
-        double s2 = 0.0; // Terminos con indice par
-
-        for (int i = 1; i < n; i++)
-        {
-            double fx = func.evaluate(a + i * h);
-            if (i % 2 == 0) s2 += fx;
-            else            s1 += fx;
-        }
-
-        return (h / 3.0) * (s0 + 4.0 * s1 + 2.0 * s2);
-    }
-}
\ No newline at end of file
+}
@@ -1,40 +1,277 @@
 #ifndef NUMERICALANALYSIS_H
 #define NUMERICALANALYSIS_H
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <concepts>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
 #include <map>
+#include <new>
+#include <span>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <iostream>
 
 namespace NumericalAnalysis {
 
+    // -----------------------------------------------------------------
+    //  Número dual  v + d·ε  (ε² = 0)  para diferenciación automática
+    //  en modo adelante: d lleva la derivada respecto a la variable.
+    // -----------------------------------------------------------------
+
+    struct Dual {
+        double value      = 0.0;
+        double derivative = 0.0;
+    };
+
+    inline Dual operator+(Dual a, Dual b)   { return {a.value + b.value, a.derivative + b.derivative}; }
+    inline Dual operator-(Dual a, Dual b)   { return {a.value - b.value, a.derivative - b.derivative}; }
+    inline Dual operator-(Dual a)           { return {-a.value, -a.derivative}; }
+    inline Dual operator*(Dual a, Dual b)   { return {a.value * b.value, a.derivative * b.value + a.value * b.derivative}; }
+    inline Dual operator/(Dual a, Dual b)
+    {
+        return {a.value / b.value, (a.derivative * b.value - a.value * b.derivative) / (b.value * b.value)};
+    }
+    inline Dual operator+(Dual a, double b) { return {a.value + b, a.derivative}; }
+    inline Dual operator+(double a, Dual b) { return {a + b.value, b.derivative}; }
+    inline Dual operator-(Dual a, double b) { return {a.value - b, a.derivative}; }
+    inline Dual operator-(double a, Dual b) { return {a - b.value, -b.derivative}; }
+    inline Dual operator*(Dual a, double b) { return {a.value * b, a.derivative * b}; }
+    inline Dual operator*(double a, Dual b) { return {a * b.value, a * b.derivative}; }
+    inline Dual operator/(Dual a, double b) { return {a.value / b, a.derivative / b}; }
+    inline Dual operator/(double a, Dual b) { return Dual{a, 0.0} / b; }
+
+    inline Dual sin (Dual a) { return {std::sin(a.value),  std::cos(a.value) * a.derivative}; }
+    inline Dual cos (Dual a) { return {std::cos(a.value), -std::sin(a.value) * a.derivative}; }
+    inline Dual tan (Dual a) { double t = std::tan(a.value); return {t, (1.0 + t * t) * a.derivative}; }
+    inline Dual exp (Dual a) { double e = std::exp(a.value); return {e, e * a.derivative}; }
+    inline Dual log (Dual a) { return {std::log(a.value), a.derivative / a.value}; }
+    inline Dual sqrt(Dual a) { double r = std::sqrt(a.value); return {r, a.derivative / (2.0 * r)}; }
+    inline Dual pow (Dual a, int n)
+    {
+        if (n == 0) return {1.0, 0.0};
+        double p = std::pow(a.value, n - 1);
+        return {p * a.value, n * p * a.derivative};
+    }
+
+    // -----------------------------------------------------------------
+    //  Aritmética de intervalos  [lo, hi]
+    //
+    //  Cada operación devuelve un intervalo que contiene todos los valores
+    //  posibles del resultado; los extremos se redondean hacia afuera un
+    //  ulp, así que el encierro es garantizado aun con el error de libm.
+    //  Un intervalo que contiene un polo da [-inf, inf].
+    // -----------------------------------------------------------------
+
+    struct Interval {
+        double lo = 0.0;
+        double hi = 0.0;
+
+        constexpr Interval() = default;
+        constexpr Interval(double v) : lo(v), hi(v) {}
+        constexpr Interval(double lo, double hi) : lo(lo), hi(hi) {}
+
+        double width   () const { return hi - lo; }
+        double midpoint() const { return lo + 0.5 * (hi - lo); }
+        bool   contains(double v) const { return lo <= v && v <= hi; }
+    };
+
+    inline Interval outward(double lo, double hi)
+    {
+        return {std::nextafter(lo, -INFINITY), std::nextafter(hi, INFINITY)};
+    }
+
+    inline Interval operator+(Interval a, Interval b) { return outward(a.lo + b.lo, a.hi + b.hi); }
+    inline Interval operator-(Interval a, Interval b) { return outward(a.lo - b.hi, a.hi - b.lo); }
+    inline Interval operator-(Interval a)             { return {-a.hi, -a.lo}; }
+    inline Interval operator*(Interval a, Interval b)
+    {
+        double p1 = a.lo * b.lo, p2 = a.lo * b.hi, p3 = a.hi * b.lo, p4 = a.hi * b.hi;
+        return outward(std::min(std::min(p1, p2), std::min(p3, p4)),
+                       std::max(std::max(p1, p2), std::max(p3, p4)));
+    }
+    inline Interval operator/(Interval a, Interval b)
+    {
+        if (b.lo <= 0.0 && b.hi >= 0.0) return {-INFINITY, INFINITY};
+        return a * outward(1.0 / b.hi, 1.0 / b.lo);
+    }
+
+    Interval sin (Interval a);
+    Interval cos (Interval a);
+    Interval tan (Interval a);
+    Interval exp (Interval a);
+    Interval log (Interval a);
+    Interval sqrt(Interval a);
+    Interval pow (Interval a, int n);
+
+    // Orden máximo para Function::evaluate_derivatives (series de Taylor truncadas)
+    constexpr int MAX_TAYLOR_ORDER = 8;
+
+    // -----------------------------------------------------------------
+    //  Árbol de expresión en un arreglo plano: cada nodo referencia a sus
+    //  hijos por índice y los hijos siempre aparecen antes que el padre,
+    //  así que recorrer el arreglo en orden es evaluarlo (cinta / tape).
+    // -----------------------------------------------------------------
+
+    enum class ExprOp { Const, X, Add, Sub, Mul, Div, Neg, PowInt, Pow, Sin, Cos, Tan, Exp, Ln, Sqrt };
+
+    struct ExprNode {
+        ExprOp op;
+        int    lhs   = -1;
+        int    rhs   = -1;
+        double value = 0.0;     // Const: valor; PowInt: exponente entero
+        int    pair  = -1;      // Sin/Cos: nodo con el mismo argumento (un solo sincos)
+    };
+
     class Function {
     private:
+        // Forma compilada de cada término: coefficient * k(scale * x^exponent + offset).
+        // SinCos fusiona sin y cos del mismo argumento: coefficient * sin + cos_coefficient * cos
+        enum class TermKind { Power, Sin, Cos, Tan, Exp, SinCos };
+        struct Term {
+            TermKind kind;
+            double   coefficient;
+            int      exponent;
+            double   scale;
+            double   offset;
+            double   cos_coefficient = 0.0;
+        };
+
         std::map            <std::string, double>               coeff;
+        std::vector         <Term>                              program;
+        // Si todos los términos son x^N: coeficientes densos, poly[k] acompaña a x^k
+        bool                                                    polynomial = true;
+        std::vector         <double>                            poly;
+        // Términos que no encajan en una llave de coeff (p. ej. sin(2x+1), x/ln(x));
+        // su suma se evalúa como cinta, la raíz es el último nodo.
+        std::vector         <ExprNode>                          expr;
         bool valid_key      (const std::string& key)            const;
-        double evaluate_key (const std::string& key, double x)  const;
+        bool lower_key      (const std::string& key, double coef, Term& term) const;
+        void compile        ();
 
     public:
         Function();
         double  evaluate                (double x) const;
         double  derivate_evaluate       (double x) const;
+        void    evaluate_with_derivative(double x, double& fx, double& dfx) const;
+        Dual    evaluate                (Dual x) const;
+        Interval evaluate               (Interval x) const;
+        void    evaluate_derivatives    (double x, int order, double* derivatives) const;
+        void    evaluate_many           (std::span<const double> xs, std::span<double> out) const;
+        void    derivate_evaluate_many  (std::span<const double> xs, std::span<double> out) const;
         float   get                     (const std::string& key) const;
+        bool    contains                (const std::string& key) const;
         void    update                  (const std::string& key, float val);
         void    add                     (const std::string& key, float val);
         void    extract_expression      (const std::string& expression);
         void    print                   () const;
+        bool    is_polynomial           () const;
+        std::vector<double> polynomial_coefficients() const;
+    };
+
+    // Reserva alineada a Alignment bytes (con 64, cada fila de Matrix
+    // empieza en su propia línea de caché y sirve para cargas AVX alineadas)
+    template <typename T, std::size_t Alignment = 64>
+    struct AlignedAllocator {
+        using value_type = T;
+        template <typename U> struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+        AlignedAllocator() = default;
+        template <typename U> AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+        T* allocate(std::size_t n)
+        {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{Alignment}));
+        }
+        void deallocate(T* p, std::size_t) noexcept { ::operator delete(p, std::align_val_t{Alignment}); }
+
+        friend bool operator==(const AlignedAllocator&, const AlignedAllocator&) { return true; }
     };
 
+    // Con -DNA_BOUNDS_CHECK, operator() y row() verifican los índices y
+    // abortan al salirse (modo depuración); sin él no cuestan nada.
+#ifdef NA_BOUNDS_CHECK
+#define NA_MATRIX_CHECK(condition)                                              \
+    do { if (!(condition)) {                                                    \
+        std::cerr << "[Matrix] Index out of bounds: " #condition "\n";         \
+        std::abort(); } } while (0)
+#else
+#define NA_MATRIX_CHECK(condition) ((void)0)
+#endif
+
+    // Expresiones perezosas de matrices (ver "Aritmética de matrices")
+    struct MatrixExpressionTag {};
+
+    template <typename E>
+    concept MatrixExpression = std::derived_from<std::remove_cvref_t<E>, MatrixExpressionTag>;
+
+    template <typename T> struct MatrixLeaf;
+    template <typename E> struct MatrixTranspose;
+
+    // Vistas sin dueño (ver "Vistas de matrices"); T = double o const double
+    template <typename T> class BasicMatrixView;
+    using MatrixView      = BasicMatrixView<double>;
+    using ConstMatrixView = BasicMatrixView<const double>;
+
+    // -----------------------------------------------------------------
+    //  Matrix: un solo bloque contiguo por filas, alineado a 64 bytes.
+    //  La fila i empieza en data() + i * stride(); stride es columns
+    //  redondeado a múltiplo de 8 doubles, así todas las filas quedan
+    //  alineadas (el relleno vale 0 y no se usa). operator() y row() no
+    //  verifican índices (salvo con NA_BOUNDS_CHECK); get y set sí.
+    // -----------------------------------------------------------------
+
     class Matrix {
     private:
-        std::vector<std::vector<double>> data;
+        std::vector<double, AlignedAllocator<double>> storage;
         int rows;
         int columns;
+        int leading;        // stride entre filas, en doubles
+
+        static int padded   (int columns) { return (columns + 7) & ~7; }
+        void    swap_rows   (int a, int b);
     public:
         Matrix                          ();
         Matrix                          (const std::string& filename);
         Matrix                          (int rows, int columns);
         Matrix                          (const std::vector<std::vector<double>>& data);
+        Matrix                          (const Matrix& other)               = default;
+        Matrix                          (Matrix&& other) noexcept;
+        Matrix& operator=               (const Matrix& other)               = default;
+        Matrix& operator=               (Matrix&& other) noexcept;
+
+        // Evalúa una expresión (A + B*C - D, A.t(), 2*A, ...) en una pasada
+        template <MatrixExpression E> Matrix(const E& expression);
+        template <MatrixExpression E> Matrix& operator= (const E& expression);
+        template <MatrixExpression E> Matrix& operator+=(const E& expression);
+        template <MatrixExpression E> Matrix& operator-=(const E& expression);
+        Matrix& operator+=              (const Matrix& other);
+        Matrix& operator-=              (const Matrix& other);
+        Matrix& operator*=              (double factor);
+        MatrixTranspose<MatrixLeaf<const Matrix&>> t() const&;
+        MatrixTranspose<MatrixLeaf<Matrix>>        t() &&;
+
+        // Vistas sin copia sobre esta matriz: siguen válidas mientras la
+        // matriz no cambie de dimensiones ni se destruya
+        MatrixView      view            ();
+        ConstMatrixView view            () const;
+        MatrixView      block           (int row, int column, int rows, int columns);
+        ConstMatrixView block           (int row, int column, int rows, int columns) const;
+        MatrixView      row_view        (int i);
+        ConstMatrixView row_view        (int i) const;
+        MatrixView      column_view     (int j);
+        ConstMatrixView column_view     (int j) const;
+
+        // Cambia las dimensiones; solo reserva si cambian (el contenido no se conserva)
+        void    resize                  (int rows, int columns);
         void    set                     (int row, int column, double value);
         double  get                     (int row, int column) const;
         void    print                   () const;
@@ -50,34 +287,1685 @@ namespace NumericalAnalysis {
         void    write_to_file           (const std::string& filename) const;
         int     getRows                 () const;
         int     getCols                 () const;
+
+        int           stride            () const { return leading; }
+        double*       data              ()       { return storage.data(); }
+        const double* data              () const { return storage.data(); }
+
+        double* row(int i)
+        {
+            NA_MATRIX_CHECK(i >= 0 && i < rows);
+            return storage.data() + static_cast<std::size_t>(i) * leading;
+        }
+        const double* row(int i) const
+        {
+            NA_MATRIX_CHECK(i >= 0 && i < rows);
+            return storage.data() + static_cast<std::size_t>(i) * leading;
+        }
+        double& operator()(int i, int j)
+        {
+            NA_MATRIX_CHECK(i >= 0 && i < rows && j >= 0 && j < columns);
+            return storage[static_cast<std::size_t>(i) * leading + j];
+        }
+        double operator()(int i, int j) const
+        {
+            NA_MATRIX_CHECK(i >= 0 && i < rows && j >= 0 && j < columns);
+            return storage[static_cast<std::size_t>(i) * leading + j];
+        }
     };
     
-    static double eval_arg          (const std::string &arg, double x);
-    static double eval_arg_deriv    (const std::string &arg, double x);
+    // -----------------------------------------------------------------
+    //  GEMM:  C = alpha * A * B + beta * C   (C ya dimensionada, m×n)
+    //
+    //  Bloqueo al estilo BLIS: B se empaqueta en paneles de GEMM_NR
+    //  columnas (kc×NR, viven en L1) y A en paneles de GEMM_MR filas
+    //  (bloques mc×kc en L2); un micro-kernel MR×NR acumula en registros.
+    //  El micro-kernel (AVX-512, AVX2+FMA o una versión portable que el
+    //  compilador vectoriza) se elige en tiempo de ejecución según la CPU.
+    //  Los bloques de filas de C se reparten con parallel_for (threads = 0:
+    //  todos los núcleos); los productos pequeños (2mnk < 2^24 flops) van
+    //  siempre en un hilo. C no reserva nada nuevo; si la memoria de C se
+    //  solapa con la de A o B, ese operando se copia antes. Con beta = 0 no se
+    //  lee C (da igual si tenía NaN). A, B y C pueden ser Matrix o vistas
+    //  (paneles de una matriz mayor) con columnas contiguas
+    //  (column_stride() == 1); una transpuesta se copia antes con Matrix(v).
+    // -----------------------------------------------------------------
+
+    void gemm(double alpha, ConstMatrixView A, ConstMatrixView B, double beta, MatrixView C, int threads = 0);
+
+    // La misma operación sobre bloques crudos por filas (estilo BLAS):
+    // A es m×k con stride lda, B k×n con ldb y C m×n con ldc. Sirve para
+    // operar sobre submatrices sin copiarlas (p. ej. la LU por bloques);
+    // aquí C no puede solaparse con A ni con B.
+    void gemm(int m, int n, int k, double alpha, const double* A, int lda, const double* B, int ldb,
+              double beta, double* C, int ldc, int threads = 0);
+
+    // -----------------------------------------------------------------
+    //  Aritmética de matrices con evaluación perezosa
+    //
+    //      Matrix X = A + B*C - 2.0*D;     X += A.t();     Y = (A - B).t();
+    //
+    //  Los operadores no calculan nada: arman un árbol de nodos que se
+    //  evalúa al asignarlo a una Matrix. Cada nodo sabe escribirse en el
+    //  destino (assign_to: dest = alpha * e) o acumularse (add_to:
+    //  dest += alpha * e):
+    //    - una cadena elemento a elemento (+, -, escalar, .t()) se recorre
+    //      en una sola pasada sin temporales;
+    //    - un producto se evalúa con gemm directamente sobre el destino,
+    //      y si está dentro de una suma se acumula con beta = 1
+    //      (A + B*C es copiar A y un gemm, sin temporal para B*C);
+    //    - solo se materializa un temporal para un operando de un
+    //      producto que no sea una Matrix (p. ej. (A + B) * C o A.t() * B).
+    //  Una Matrix con nombre entra por referencia; una temporal se mueve
+    //  dentro del árbol. Si el destino aparece en la expresión de forma
+    //  que no es segura elemento a elemento (producto o transpuesta), se
+    //  evalúa en un temporal y se mueve. Como en cualquier biblioteca de
+    //  expresiones, no guarde el árbol con auto más allá de la sentencia
+    //  si referencia temporales.
+    // -----------------------------------------------------------------
+
+    template <typename T>
+    concept MatrixOperand = MatrixExpression<T> || std::same_as<std::remove_cvref_t<T>, Matrix>;
+
+    template <typename Derived>
+    struct MatrixNode : MatrixExpressionTag {
+        // Evaluación fusionada de nodos elemento a elemento vía at(i, j)
+        void assign_to(Matrix& dest, double alpha) const
+        {
+            const Derived& e = self();
+            dest.resize(e.rows(), e.cols());
+            for (int i = 0; i < dest.getRows(); i++)
+            {
+                double *d = dest.row(i);
+                for (int j = 0; j < dest.getCols(); j++) d[j] = alpha * e.at(i, j);
+            }
+        }
+        void add_to(Matrix& dest, double alpha) const
+        {
+            const Derived& e = self();
+            for (int i = 0; i < dest.getRows(); i++)
+            {
+                double *d = dest.row(i);
+                for (int j = 0; j < dest.getCols(); j++) d[j] += alpha * e.at(i, j);
+            }
+        }
+
+        MatrixTranspose<Derived> t() const& { return MatrixTranspose<Derived>(self()); }
+        MatrixTranspose<Derived> t() &&     { return MatrixTranspose<Derived>(std::move(*static_cast<Derived*>(this))); }
+
+    protected:
+        const Derived& self() const { return static_cast<const Derived&>(*this); }
+    };
+
+    // Hoja: T = const Matrix& (Matrix con nombre) o Matrix (temporal movida)
+    template <typename T>
+    struct MatrixLeaf : MatrixNode<MatrixLeaf<T>> {
+        static constexpr bool elementwise = true;
+        static constexpr bool alias_safe  = true;
+        T m;
+
+        explicit MatrixLeaf(T m) : m(std::forward<T>(m)) {}
+
+        int     rows        () const { return m.getRows(); }
+        int     cols        () const { return m.getCols(); }
+        bool    valid       () const { return true; }
+        bool    references  (const Matrix* p) const { return &m == p; }
+        double  at          (int i, int j) const { return m(i, j); }
+        const Matrix& value () const { return m; }
+    };
+
+    template <typename T>
+    auto as_matrix_node(T&& x)
+    {
+        if constexpr (MatrixExpression<T>)            return std::remove_cvref_t<T>(std::forward<T>(x));
+        else if constexpr (std::is_lvalue_reference_v<T>) return MatrixLeaf<const Matrix&>(x);
+        else                                           return MatrixLeaf<Matrix>(std::move(x));
+    }
+
+    template <typename T>
+    using matrix_node_t = decltype(as_matrix_node(std::declval<T>()));
+
+    // Operando de un producto como Matrix: la misma si es hoja, si no un temporal
+    template <typename E>
+    decltype(auto) materialize(const E& e)
+    {
+        if constexpr (requires { e.value(); }) return e.value();
+        else                                   return Matrix(e);
+    }
+
+    template <typename L, typename R, int Sign>
+    struct MatrixSum : MatrixNode<MatrixSum<L, R, Sign>> {
+        static constexpr bool elementwise = L::elementwise && R::elementwise;
+        static constexpr bool alias_safe  = elementwise && L::alias_safe && R::alias_safe;
+        L l; R r;
+
+        MatrixSum(L l, R r) : l(std::move(l)), r(std::move(r)) {}
+
+        int     rows        () const { return l.rows(); }
+        int     cols        () const { return l.cols(); }
+        bool    valid       () const { return l.valid() && r.valid() && l.rows() == r.rows() && l.cols() == r.cols(); }
+        bool    references  (const Matrix* p) const { return l.references(p) || r.references(p); }
+        double  at          (int i, int j) const requires elementwise { return l.at(i, j) + Sign * r.at(i, j); }
+
+        void assign_to(Matrix& dest, double alpha) const
+        {
+            if constexpr (elementwise) MatrixNode<MatrixSum>::assign_to(dest, alpha);
+            else { l.assign_to(dest, alpha); r.add_to(dest, Sign * alpha); }
+        }
+        void add_to(Matrix& dest, double alpha) const
+        {
+            if constexpr (elementwise) MatrixNode<MatrixSum>::add_to(dest, alpha);
+            else { l.add_to(dest, alpha); r.add_to(dest, Sign * alpha); }
+        }
+    };
+
+    template <typename E>
+    struct MatrixScaled : MatrixNode<MatrixScaled<E>> {
+        static constexpr bool elementwise = E::elementwise;
+        static constexpr bool alias_safe  = E::alias_safe;
+        E      e;
+        double factor;
+
+        MatrixScaled(E e, double factor) : e(std::move(e)), factor(factor) {}
+
+        int     rows        () const { return e.rows(); }
+        int     cols        () const { return e.cols(); }
+        bool    valid       () const { return e.valid(); }
+        bool    references  (const Matrix* p) const { return e.references(p); }
+        double  at          (int i, int j) const requires elementwise { return factor * e.at(i, j); }
+
+        void assign_to(Matrix& dest, double alpha) const { e.assign_to(dest, alpha * factor); }
+        void add_to   (Matrix& dest, double alpha) const { e.add_to(dest, alpha * factor); }
+    };
+
+    template <typename L, typename R>
+    struct MatrixProduct : MatrixNode<MatrixProduct<L, R>> {
+        static constexpr bool elementwise = false;
+        static constexpr bool alias_safe  = false;
+        L l; R r;
+
+        MatrixProduct(L l, R r) : l(std::move(l)), r(std::move(r)) {}
+
+        int     rows        () const { return l.rows(); }
+        int     cols        () const { return r.cols(); }
+        bool    valid       () const { return l.valid() && r.valid() && l.cols() == r.rows(); }
+        bool    references  (const Matrix* p) const { return l.references(p) || r.references(p); }
+
+        void assign_to(Matrix& dest, double alpha) const
+        {
+            const auto& a = materialize(l);
+            const auto& b = materialize(r);
+            dest.resize(rows(), cols());
+            gemm(alpha, a, b, 0.0, dest);
+        }
+        void add_to(Matrix& dest, double alpha) const
+        {
+            const auto& a = materialize(l);
+            const auto& b = materialize(r);
+            gemm(alpha, a, b, 1.0, dest);
+        }
+    };
+
+    template <typename E>
+    struct MatrixTranspose : MatrixNode<MatrixTranspose<E>> {
+        static constexpr bool elementwise = E::elementwise;
+        static constexpr bool alias_safe  = false;
+        E e;
+
+        explicit MatrixTranspose(E e) : e(std::move(e)) {}
+
+        int     rows        () const { return e.cols(); }
+        int     cols        () const { return e.rows(); }
+        bool    valid       () const { return e.valid(); }
+        bool    references  (const Matrix* p) const { return e.references(p); }
+        double  at          (int i, int j) const requires elementwise { return e.at(j, i); }
+
+        void assign_to(Matrix& dest, double alpha) const
+        {
+            if constexpr (elementwise) MatrixNode<MatrixTranspose>::assign_to(dest, alpha);
+            else MatrixTranspose<MatrixLeaf<Matrix>>(MatrixLeaf<Matrix>(Matrix(e))).assign_to(dest, alpha);
+        }
+        void add_to(Matrix& dest, double alpha) const
+        {
+            if constexpr (elementwise) MatrixNode<MatrixTranspose>::add_to(dest, alpha);
+            else MatrixTranspose<MatrixLeaf<Matrix>>(MatrixLeaf<Matrix>(Matrix(e))).add_to(dest, alpha);
+        }
+    };
+
+    template <MatrixOperand L, MatrixOperand R>
+    auto operator+(L&& l, R&& r)
+    {
+        return MatrixSum<matrix_node_t<L>, matrix_node_t<R>, 1>(as_matrix_node(std::forward<L>(l)), as_matrix_node(std::forward<R>(r)));
+    }
+
+    template <MatrixOperand L, MatrixOperand R>
+    auto operator-(L&& l, R&& r)
+    {
+        return MatrixSum<matrix_node_t<L>, matrix_node_t<R>, -1>(as_matrix_node(std::forward<L>(l)), as_matrix_node(std::forward<R>(r)));
+    }
+
+    template <MatrixOperand L, MatrixOperand R>
+    auto operator*(L&& l, R&& r)
+    {
+        return MatrixProduct<matrix_node_t<L>, matrix_node_t<R>>(as_matrix_node(std::forward<L>(l)), as_matrix_node(std::forward<R>(r)));
+    }
+
+    template <MatrixOperand E>
+    auto operator*(double factor, E&& e) { return MatrixScaled<matrix_node_t<E>>(as_matrix_node(std::forward<E>(e)), factor); }
+
+    template <MatrixOperand E>
+    auto operator*(E&& e, double factor) { return MatrixScaled<matrix_node_t<E>>(as_matrix_node(std::forward<E>(e)), factor); }
+
+    template <MatrixOperand E>
+    auto operator/(E&& e, double divisor) { return MatrixScaled<matrix_node_t<E>>(as_matrix_node(std::forward<E>(e)), 1.0 / divisor); }
+
+    template <MatrixOperand E>
+    auto operator-(E&& e) { return MatrixScaled<matrix_node_t<E>>(as_matrix_node(std::forward<E>(e)), -1.0); }
+
+    inline MatrixTranspose<MatrixLeaf<const Matrix&>> Matrix::t() const&
+    {
+        return MatrixTranspose<MatrixLeaf<const Matrix&>>(MatrixLeaf<const Matrix&>(*this));
+    }
+
+    inline MatrixTranspose<MatrixLeaf<Matrix>> Matrix::t() &&
+    {
+        return MatrixTranspose<MatrixLeaf<Matrix>>(MatrixLeaf<Matrix>(std::move(*this)));
+    }
+
+    template <MatrixExpression E>
+    Matrix::Matrix(const E& expression) : Matrix()
+    {
+        if (!expression.valid())
+        {
+            std::cerr << "[Matrix] Dimension mismatch in expression\n";
+            return;
+        }
+        expression.assign_to(*this, 1.0);
+    }
+
+    template <MatrixExpression E>
+    Matrix& Matrix::operator=(const E& expression)
+    {
+        if (!expression.valid())
+        {
+            std::cerr << "[Matrix] Dimension mismatch in expression\n";
+            return *this;
+        }
+        if (!E::alias_safe && expression.references(this))
+            *this = Matrix(expression);
+        else
+            expression.assign_to(*this, 1.0);
+        return *this;
+    }
+
+    template <MatrixExpression E>
+    Matrix& Matrix::operator+=(const E& expression)
+    {
+        if (!expression.valid() || expression.rows() != rows || expression.cols() != columns)
+        {
+            std::cerr << "[Matrix::operator+=] Dimension mismatch\n";
+            return *this;
+        }
+        if (!E::alias_safe && expression.references(this))
+            return *this += Matrix(expression);
+        expression.add_to(*this, 1.0);
+        return *this;
+    }
+
+    template <MatrixExpression E>
+    Matrix& Matrix::operator-=(const E& expression)
+    {
+        if (!expression.valid() || expression.rows() != rows || expression.cols() != columns)
+        {
+            std::cerr << "[Matrix::operator-=] Dimension mismatch\n";
+            return *this;
+        }
+        if (!E::alias_safe && expression.references(this))
+            return *this -= Matrix(expression);
+        expression.add_to(*this, -1.0);
+        return *this;
+    }
+
+    // -----------------------------------------------------------------
+    //  Vistas de matrices (sin copia)
+    //
+    //      ConstMatrixView A = aug.block(0, 0, n, n);   // A de [A|b]
+    //      ConstMatrixView b = aug.column_view(n);      // b de [A|b]
+    //      LUDecomposition lu(A);  Matrix x = lu.solve(b);
+    //
+    //  Una vista es un puntero más dimensiones y dos strides: el
+    //  elemento (i, j) está en data()[i * row_stride() + j * column_stride()].
+    //  Así un bloque, una fila, una columna o una transpuesta (strides
+    //  intercambiados) son la misma clase y crearlas no copia nada. No es
+    //  dueña de la memoria: vale mientras la Matrix de origen no cambie de
+    //  dimensiones ni se destruya. MatrixView permite escribir,
+    //  ConstMatrixView no; una Matrix se convierte sola en cualquiera de
+    //  las dos, así que los sistemas lineales, gemm y LUDecomposition
+    //  aceptan una Matrix o una vista por igual.
+    //
+    //  Una vista es también una hoja de la aritmética perezosa
+    //  (Matrix X = A.block(0, 0, k, k) + B; Matrix C = v;) y copiarla a
+    //  una Matrix usa copias de filas completas si las columnas son
+    //  contiguas. Copiar o asignar una vista copia la vista, no los datos;
+    //  para escribir datos en ella use copy_from o fill.
+    // -----------------------------------------------------------------
+
+    template <typename T>
+    class BasicMatrixView : public MatrixNode<BasicMatrixView<T>> {
+    private:
+        T*  base    = nullptr;
+        int nrows   = 0;
+        int ncols   = 0;
+        int rstride = 0;    // entre filas, en doubles
+        int cstride = 1;    // entre columnas, en doubles
+    public:
+        static constexpr bool elementwise = true;
+        static constexpr bool alias_safe  = false;
+
+        BasicMatrixView() = default;
+        BasicMatrixView(T* data, int rows, int columns, int row_stride, int column_stride = 1)
+            : base(data), nrows(rows), ncols(columns), rstride(row_stride), cstride(column_stride) {}
+        BasicMatrixView(Matrix& m) requires (!std::is_const_v<T>)
+            : BasicMatrixView(m.data(), m.getRows(), m.getCols(), m.stride()) {}
+        BasicMatrixView(const Matrix& m) requires std::is_const_v<T>
+            : BasicMatrixView(m.data(), m.getRows(), m.getCols(), m.stride()) {}
+        template <typename U> requires (std::is_const_v<T> && std::same_as<U, double>)
+        BasicMatrixView(const BasicMatrixView<U>& v)
+            : BasicMatrixView(v.data(), v.rows(), v.cols(), v.row_stride(), v.column_stride()) {}
+
+        int     rows            () const { return nrows; }
+        int     cols            () const { return ncols; }
+        int     getRows         () const { return nrows; }
+        int     getCols         () const { return ncols; }
+        int     row_stride      () const { return rstride; }
+        int     column_stride   () const { return cstride; }
+        T*      data            () const { return base; }
+
+        T& operator()(int i, int j) const
+        {
+            NA_MATRIX_CHECK(i >= 0 && i < nrows && j >= 0 && j < ncols);
+            return base[static_cast<std::ptrdiff_t>(i) * rstride + static_cast<std::ptrdiff_t>(j) * cstride];
+        }
+
+        // Sub-vista de rows×columns desde (row, column); fuera de rango avisa y da una vista vacía
+        BasicMatrixView block(int row, int column, int rows, int columns) const
+        {
+            if (row < 0 || column < 0 || rows < 0 || columns < 0 || row + rows > nrows || column + columns > ncols)
+            {
+                std::cerr << "[MatrixView::block] Block (" << row << ", " << column << ") of "
+                          << rows << "x" << columns << " out of " << nrows << "x" << ncols << "\n";
+                return BasicMatrixView();
+            }
+            return BasicMatrixView(base + static_cast<std::ptrdiff_t>(row) * rstride + static_cast<std::ptrdiff_t>(column) * cstride,
+                                   rows, columns, rstride, cstride);
+        }
+        BasicMatrixView row_view    (int i) const { return block(i, 0, 1, ncols); }
+        BasicMatrixView column_view (int j) const { return block(0, j, nrows, 1); }
+        BasicMatrixView t           () const { return BasicMatrixView(base, ncols, nrows, cstride, rstride); }
+
+        // Copia elemento a elemento desde otra vista de las mismas dimensiones
+        void copy_from(BasicMatrixView<const double> source) const requires (!std::is_const_v<T>)
+        {
+            if (source.rows() != nrows || source.cols() != ncols)
+            {
+                std::cerr << "[MatrixView::copy_from] Dimension mismatch (" << source.rows() << "x"
+                          << source.cols() << " into " << nrows << "x" << ncols << ")\n";
+                return;
+            }
+            for (int i = 0; i < nrows; i++)
+                for (int j = 0; j < ncols; j++) (*this)(i, j) = source(i, j);
+        }
+        void fill(double value) const requires (!std::is_const_v<T>)
+        {
+            for (int i = 0; i < nrows; i++)
+                for (int j = 0; j < ncols; j++) (*this)(i, j) = value;
+        }
+
+        bool    valid       () const { return true; }
+        double  at          (int i, int j) const { return (*this)(i, j); }
+
+        // ¿Cae la vista dentro de los datos de p? (alias en A = A.block(...))
+        bool references(const Matrix* p) const
+        {
+            const double *first = base;
+            return nrows > 0 && ncols > 0 && first >= p->data()
+                && first < p->data() + static_cast<std::size_t>(p->getRows()) * p->stride();
+        }
+
+        void assign_to(Matrix& dest, double alpha) const
+        {
+            if (cstride != 1 || alpha != 1.0) { MatrixNode<BasicMatrixView>::assign_to(dest, alpha); return; }
+            dest.resize(nrows, ncols);
+            for (int i = 0; i < nrows; i++)
+                std::copy_n(base + static_cast<std::ptrdiff_t>(i) * rstride, ncols, dest.row(i));
+        }
+    };
+
+    inline MatrixView      Matrix::view        ()       { return MatrixView(*this); }
+    inline ConstMatrixView Matrix::view        () const { return ConstMatrixView(*this); }
+    inline MatrixView      Matrix::block       (int row, int column, int rows, int columns)       { return view().block(row, column, rows, columns); }
+    inline ConstMatrixView Matrix::block       (int row, int column, int rows, int columns) const { return view().block(row, column, rows, columns); }
+    inline MatrixView      Matrix::row_view    (int i)       { return view().row_view(i); }
+    inline ConstMatrixView Matrix::row_view    (int i) const { return view().row_view(i); }
+    inline MatrixView      Matrix::column_view (int j)       { return view().column_view(j); }
+    inline ConstMatrixView Matrix::column_view (int j) const { return view().column_view(j); }
 
     bool evaluate_tolerance (double xn, double xnp1, double tolerance);
 
-    double bisection        (Function func, double point_a, double point_b, double tolerance, int iterations);
-    double fixed_point      (Function func, double initial_point, double tolerance, int iterations);
-    double fake_position    (Function func, double point_a, double point_b, double tolerance, int iterations);
-    double newton_raphson   (Function func, double initial_point, double tolerance, int iterations);
-    double secant_method    (Function func, double point_a, double point_b, double tolerance, int iterations);
+    // -----------------------------------------------------------------
+    //  Ejecución en paralelo con robo de trabajo
+    //
+    //  Reparte los índices [0, n) entre threads hilos (0 = todos los
+    //  núcleos; el hilo que llama también trabaja). Cada hilo consume su
+    //  propio rango de a grain índices y, cuando se le acaba, le roba la
+    //  mitad restante al rango más largo de otro hilo, así que las tareas
+    //  de costo muy dispar (iteraciones que varían) se reequilibran solas.
+    //  body(begin, end) procesa los índices [begin, end) y debe ser seguro
+    //  de llamar desde varios hilos a la vez. Los hilos son de un pool
+    //  que se crea en la primera llamada y se reutiliza (uno por núcleo),
+    //  así que threads mayor que los núcleos solo parte más fino el
+    //  trabajo. Se puede anidar: si el pool está ocupado, el hilo que
+    //  llama hace el trabajo restante.
+    // -----------------------------------------------------------------
+
+    void parallel_for(std::size_t n, const std::function<void(std::size_t, std::size_t)>& body,
+                      int threads = 0, std::size_t grain = 1);
+
+
+    // -----------------------------------------------------------------
+    //  Los métodos de ceros y de integración son plantillas sobre F y
+    //  reciben la función por referencia constante (sin copiar el mapa de
+    //  Function). F puede ser:
+    //    - Function, o una expresión estática de expressiontemplates.h
+    //      (p. ej. 3*pow<2>(x) + sin(pow<3>(x))): se usa f.evaluate(x);
+    //    - cualquier invocable double(double): lambda, functor, puntero.
+    //  Newton pide además la derivada, que sale de (en este orden)
+    //  f.evaluate_with_derivative, de un invocable que devuelve el par
+    //  {f(x), f'(x)}, o de un invocable genérico evaluado con Dual.
+    // -----------------------------------------------------------------
+
+    template <typename F>
+    concept HasEvaluate = requires(const F& f, double x) {
+        { f.evaluate(x) } -> std::convertible_to<double>;
+    };
+
+    template <typename F>
+    concept Evaluable = HasEvaluate<F> || std::is_invocable_r_v<double, const F&, double>;
+
+    template <typename F>
+    concept Differentiable =
+        requires(const F& f, double x, double& fx, double& dfx) { f.evaluate_with_derivative(x, fx, dfx); } ||
+        requires(const F& f, double x) { { f(x) } -> std::convertible_to<std::pair<double, double>>; } ||
+        requires(const F& f, Dual x) { { f(x) } -> std::convertible_to<Dual>; };
+
+    template <Evaluable F>
+    inline double evaluate_at(const F& func, double x)
+    {
+        if constexpr (HasEvaluate<F>) return func.evaluate(x);
+        else                          return func(x);
+    }
+
+    template <Differentiable F>
+    inline void evaluate_at_with_derivative(const F& func, double x, double& fx, double& dfx)
+    {
+        if constexpr (requires { func.evaluate_with_derivative(x, fx, dfx); })
+            func.evaluate_with_derivative(x, fx, dfx);
+        else if constexpr (requires { { func(x) } -> std::convertible_to<std::pair<double, double>>; })
+        {
+            std::pair<double, double> r = func(x);
+            fx  = r.first;
+            dfx = r.second;
+        }
+        else
+        {
+            Dual r = func(Dual{x, 1.0});
+            fx  = r.value;
+            dfx = r.derivative;
+        }
+    }
+
+    // -----------------------------------------------------------------
+    //  Caché de evaluaciones para funciones costosas
+    //
+    //  Envuelve cualquier F evaluable. Es una tabla de acceso directo de
+    //  Slots entradas indexada por el patrón de bits del double, así que
+    //  solo acierta con abscisas idénticas (extremos que se repiten en los
+    //  métodos de intervalo, nodos compartidos entre reglas). Cuenta las
+    //  llamadas recibidas y las evaluaciones reales de la función, que es
+    //  el número que importa cuando f es un modelo caro.
+    //
+    //  Guarda una referencia a func: no debe vivir más que ella. No es
+    //  seguro compartir una instancia entre hilos.
+    // -----------------------------------------------------------------
+
+    template <Evaluable F, std::size_t Slots = 64>
+    class CachedFunction {
+        static_assert(Slots > 0 && (Slots & (Slots - 1)) == 0, "Slots debe ser potencia de 2");
+
+        const F&                                func;
+        mutable std::array<std::uint64_t, Slots> keys{};
+        mutable std::array<double, Slots>        values{};
+        mutable std::array<bool, Slots>          used{};
+        mutable std::size_t                      call_count       = 0;
+        mutable std::size_t                      evaluation_count = 0;
+        mutable std::size_t                      derivative_count = 0;
+
+        static std::size_t slot_of(std::uint64_t bits)
+        {
+            // Multiplicativo (Fibonacci) tomando los bits altos del producto:
+            // abscisas "redondas" (a + i*h diádicos) tienen la mantisa baja en cero
+            if constexpr (Slots == 1) return 0;
+            else return static_cast<std::size_t>((bits * 0x9E3779B97F4A7C15ull) >> (64 - std::countr_zero(Slots)));
+        }
+
+    public:
+        explicit CachedFunction(const F& func) : func(func) {}
+
+        double evaluate(double x) const
+        {
+            call_count++;
+            std::uint64_t bits = std::bit_cast<std::uint64_t>(x);
+            std::size_t   slot = slot_of(bits);
+            if (used[slot] && keys[slot] == bits) return values[slot];
+
+            evaluation_count++;
+            double fx = evaluate_at(func, x);
+            keys[slot]   = bits;
+            values[slot] = fx;
+            used[slot]   = true;
+            return fx;
+        }
+
+        // La derivada no se guarda, pero el valor sí queda en la tabla
+        void evaluate_with_derivative(double x, double& fx, double& dfx) const requires Differentiable<F>
+        {
+            call_count++;
+            evaluation_count++;
+            derivative_count++;
+            evaluate_at_with_derivative(func, x, fx, dfx);
+            std::uint64_t bits = std::bit_cast<std::uint64_t>(x);
+            std::size_t   slot = slot_of(bits);
+            keys[slot]   = bits;
+            values[slot] = fx;
+            used[slot]   = true;
+        }
+
+        std::size_t calls                () const { return call_count; }
+        std::size_t evaluations          () const { return evaluation_count; }
+        std::size_t derivative_evaluations() const { return derivative_count; }
+        std::size_t hits                 () const { return call_count - evaluation_count; }
+
+        void reset_counters() { call_count = evaluation_count = derivative_count = 0; }
+        void clear         () { used.fill(false); reset_counters(); }
+    };
+
+    // -----------------------------------------------------------------
+    //  Aislamiento de raíces por ramificación y poda (branch and prune)
+    //
+    //  Se parte [a, b] por la mitad recursivamente y se descarta todo
+    //  subintervalo cuyo encierro f([lo, hi]) no contiene 0: ahí no puede
+    //  haber raíz. Las cajas que sobreviven con ancho <= width se devuelven
+    //  en orden, fusionando las contiguas. Toda raíz de [a, b] queda dentro
+    //  de alguna caja devuelta; lo contrario no está garantizado (una caja
+    //  puede sobrevivir por sobreestimación), así que cada caja es un
+    //  candidato para bisection o newton_raphson. Si se agota
+    //  max_evaluations, las cajas pendientes se devuelven sin refinar.
+    // -----------------------------------------------------------------
+
+    template <typename F>
+    concept IntervalEvaluable = requires(const F& f, Interval x) {
+        { f.evaluate(x) } -> std::convertible_to<Interval>;
+    };
+
+    template <IntervalEvaluable F>
+    std::vector<Interval> isolate_roots(const F& func, double a, double b, double width, int max_evaluations = 100000)
+    {
+        std::vector<Interval> boxes;
+        std::vector<Interval> pending{Interval{std::min(a, b), std::max(a, b)}};
+        int evaluations = 0;
+
+        auto emit = [&](Interval box)
+        {
+            if (!boxes.empty() && boxes.back().hi >= box.lo) boxes.back().hi = std::max(boxes.back().hi, box.hi);
+            else boxes.push_back(box);
+        };
+
+        while (!pending.empty())
+        {
+            Interval box = pending.back();
+            pending.pop_back();
+            if (evaluations >= max_evaluations) { emit(box); continue; }
+
+            Interval fx = func.evaluate(box);
+            evaluations++;
+            if (fx.lo > 0.0 || fx.hi < 0.0) continue;     // NaN no descarta: no se sabe
+
+            if (box.width() <= width) { emit(box); continue; }
+            double m = box.midpoint();
+            pending.push_back({m, box.hi});                 // la mitad izquierda sale primero
+            pending.push_back({box.lo, m});
+        }
+
+        if (evaluations >= max_evaluations)
+            std::cerr << "[isolate_roots] Se agotaron las " << max_evaluations
+                      << " evaluaciones; algunas cajas no se refinaron\n";
+        return boxes;
+    }
+
+    // -----------------------------------------------------------------
+    //  Resultado de los métodos de ceros
+    //
+    //  root es el último iterado (también si no convergió, salvo entrada
+    //  inválida, donde es NaN); residual = |f(root)|; evaluations cuenta
+    //  todas las evaluaciones de f, incluidas las que traen derivada, que
+    //  además se cuentan en derivative_evaluations; elapsed en segundos.
+    // -----------------------------------------------------------------
+
+    enum class RootStatus { Converged, MaxIterations, NoSignChange, ZeroDerivative, InvalidInput };
+
+    const char* to_string(RootStatus status);
+
+    struct RootResult {
+        double     root                   = NAN;
+        RootStatus status                 = RootStatus::InvalidInput;
+        int        iterations             = 0;
+        int        evaluations            = 0;
+        int        derivative_evaluations = 0;
+        double     residual               = NAN;
+        double     elapsed                = 0.0;
+
+        bool converged() const { return status == RootStatus::Converged; }
+    };
+
+    template <Evaluable F>     RootResult bisection        (const F& func, double point_a, double point_b, double tolerance, int iterations);
+    template <Evaluable F>     RootResult fixed_point      (const F& func, double initial_point, double tolerance, int iterations);
+    template <Evaluable F>     RootResult fake_position    (const F& func, double point_a, double point_b, double tolerance, int iterations);
+    template <Differentiable F> RootResult newton_raphson  (const F& func, double initial_point, double tolerance, int iterations);
+    template <Evaluable F>     RootResult secant_method    (const F& func, double point_a, double point_b, double tolerance, int iterations);
+
+    // Métodos de intervalo híbridos; requieren f(a) * f(b) <= 0
+    template <Evaluable F>     RootResult brent_method     (const F& func, double point_a, double point_b, double tolerance, int iterations);
+    template <Evaluable F>     RootResult illinois_method  (const F& func, double point_a, double point_b, double tolerance, int iterations);
+    template <Evaluable F>     RootResult itp_method       (const F& func, double point_a, double point_b, double tolerance, int iterations);
+    RootResult halley_method    (const Function& func, double initial_point, double tolerance, int iterations);
+    RootResult householder_method(const Function& func, double initial_point, double tolerance, int iterations, int order);
+
+    // -----------------------------------------------------------------
+    //  Lote de problemas de raíces independientes (barridos de parámetros)
+    //
+    //  Cada RootProblem nombra su método, su función, el intervalo
+    //  [point_a, point_b] (bisección, posición falsa, secante) o el punto
+    //  inicial point_a (punto fijo, Newton, Halley), la tolerancia y el
+    //  tope de iteraciones. solve_roots los resuelve en paralelo y devuelve
+    //  los RootResult en el mismo orden. Las Function se referencian, no
+    //  se copian: deben vivir hasta que termine la llamada.
+    // -----------------------------------------------------------------
+
+    enum class RootMethod { Bisection, FixedPoint, FakePosition, NewtonRaphson, Secant, Halley };
+
+    struct RootProblem {
+        RootMethod      method     = RootMethod::Bisection;
+        const Function* function   = nullptr;
+        double          point_a    = 0.0;
+        double          point_b    = 0.0;
+        double          tolerance  = 1e-10;
+        int             iterations = 100;
+    };
+
+    RootResult              solve_root (const RootProblem& problem);
+    std::vector<RootResult> solve_roots(const std::vector<RootProblem>& problems, int threads = 0);
+
+    // -----------------------------------------------------------------
+    //  Todas las raíces (complejas) de un polinomio
+    //
+    //  coefficients[k] acompaña a x^k, el mismo orden que
+    //  Function::polynomial_coefficients. Usa la iteración simultánea de
+    //  Aberth–Ehrlich: cada aproximación z_k da un paso de Newton corregido
+    //  por la repulsión de las demás,
+    //
+    //      w_k = (p/p')(z_k) / (1 - (p/p')(z_k) * Σ_{j≠k} 1/(z_k - z_j)),
+    //
+    //  así que ninguna converge a una raíz ya tomada por otra (no hace falta
+    //  deflación). Cada z_k se congela cuando |p(z_k)| queda bajo la cota
+    //  de error de redondeo de Horner. Si no converge en iterations pasos,
+    //  se usan los valores propios de la matriz compañera (QR de Francis
+    //  sobre la matriz balanceada). Las raíces salen ordenadas por parte
+    //  real y luego imaginaria.
+    // -----------------------------------------------------------------
+
+    std::vector<std::complex<double>> polynomial_roots(const std::vector<double>& coefficients, int iterations = 100);
+    std::vector<std::complex<double>> polynomial_roots(const Function& func, int iterations = 100);
+
+    // -----------------------------------------------------------------
+    //  Todas las raíces de f en [a, b]
+    //
+    //  1. La malla de subdivisions celdas se evalúa en paralelo, por
+    //     bloques (evaluate_many cuando F lo tiene).
+    //  2. Cada celda con cambio de signo es un intervalo con raíz; un nodo
+    //     con f = 0 exacto es raíz. Si tangencies está activo, un mínimo
+    //     local de |f| sin cambio de signo se refina por sección dorada y
+    //     se acepta como raíz (doble) si |f| <= tangency_tolerance.
+    //  3. Los intervalos se refinan en paralelo con un híbrido secante /
+    //     bisección y las raíces a menos de merge_tolerance se fusionan.
+    //  Devuelve las raíces ordenadas. F debe poder evaluarse desde varios
+    //  hilos a la vez (Function y las expresiones estáticas pueden;
+    //  CachedFunction no).
+    // -----------------------------------------------------------------
+
+    struct RootScanOptions {
+        int    subdivisions       = 1000;
+        double tolerance          = 1e-12;
+        int    iterations         = 200;
+        bool   tangencies         = true;
+        double tangency_tolerance = 1e-10;
+        double merge_tolerance    = 1e-9;
+        int    threads            = 0;
+    };
+
+    template <Evaluable F>
+    std::vector<double> find_all_roots(const F& func, double a, double b, const RootScanOptions& options = {});
+
+
+    // -----------------------------------------------------------------
+    //  Continuación en un parámetro
+    //
+    //  Sigue una rama x(p) de f(x; p) = 0 mientras el coeficiente de la
+    //  llave key va de from a to (el mismo cambio que Function::update).
+    //  En cada paso el predictor es el desarrollo de la rama hasta
+    //  segundo orden, x + x' dp + x'' dp^2 / 2, con la tangente
+    //      x' = -(∂f/∂p) / f'(x)
+    //  y x'' de derivar otra vez f(x(p), p) = 0. ∂f/∂p es exacta: f es
+    //  lineal en cada coeficiente, así que ∂f/∂p es el término de key con
+    //  coeficiente 1 (y ∂²f/∂p² = 0). El corrector es newton_raphson
+    //  desde la predicción, con a lo sumo max_corrections iteraciones.
+    //  El paso crece si bastaron fast_corrections y se encoge si no; se
+    //  parte a la mitad si el corrector falla o salta más de max_jump
+    //  desde la predicción, y la continuación se detiene (status
+    //  distinto de Converged) si baja de min_step o f' se anula (un
+    //  pliegue de la rama). func no se modifica: se trabaja sobre una copia.
+    //  El parámetro queda redondeado a float por update; el barrido
+    //  termina en float(to).
+    // -----------------------------------------------------------------
+
+    struct ContinuationOptions {
+        double step             = 0.05;   // paso inicial en p (su signo se toma de to - from)
+        double min_step         = 1e-6;
+        double max_step         = 0.5;
+        double tolerance        = 1e-12;
+        int    max_corrections  = 5;
+        int    fast_corrections = 2;      // si el corrector tarda <= esto, el paso crece
+        double growth           = 1.5;
+        double max_jump         = 0.5;    // |x - predicción| máximo aceptado
+        int    iterations       = 100;    // para la solución inicial en from
+    };
+
+    struct ContinuationPoint {
+        double parameter;
+        double root;
+        int    corrections;               // iteraciones de Newton en este punto
+    };
+
+    struct ContinuationResult {
+        std::vector<ContinuationPoint> points;
+        RootStatus status      = RootStatus::InvalidInput;
+        int        corrections = 0;       // total, sin contar la solución inicial
+        int        rejected    = 0;       // pasos rechazados y repetidos más cortos
+        double     elapsed     = 0.0;
+
+        bool converged() const { return status == RootStatus::Converged; }
+    };
+
+    ContinuationResult continue_root(const Function& func, const std::string& key, double from, double to,
+                                     double initial_root, const ContinuationOptions& options = {});
+
+
+    // -----------------------------------------------------------------
+    //  Sistemas no lineales F(x) = 0, F: R^n -> R^n
+    //
+    //  F es cualquier invocable std::vector<double>(const std::vector<double>&).
+    //  Si además acepta std::vector<Dual> (una lambda genérica, p. ej.
+    //  [](const auto& x) { return std::vector{x[0]*x[1] - 1.0, ...}; }) el
+    //  jacobiano sale exacto por diferenciación automática, una pasada por
+    //  columna; si no, por diferencias hacia adelante.
+    //
+    //  newton_system refactoriza J cada refresh iteraciones (1 = Newton
+    //  puro; más es Newton–cuerda, que reutiliza el mismo factor LU).
+    //  broyden_method factoriza J una sola vez y aplica las actualizaciones
+    //  de rango uno de Broyden sobre J^{-1} con Sherman–Morrison; solo
+    //  vuelve a factorizar tras restart actualizaciones o si una falla.
+    //  Ambos usan lu_decompose / lu_solve. Converge si ||Δx||_inf < tolerance.
+    // -----------------------------------------------------------------
+
+    template <typename F>
+    concept VectorFunction = requires(const F& f, const std::vector<double>& x) {
+        { f(x) } -> std::convertible_to<std::vector<double>>;
+    };
+
+    struct SystemResult {
+        std::vector<double> root;
+        RootStatus          status               = RootStatus::InvalidInput;
+        int                 iterations           = 0;
+        int                 evaluations          = 0;   // de F (incluye las de diferencias finitas)
+        int                 jacobian_evaluations = 0;
+        int                 factorizations       = 0;
+        double              residual             = NAN; // ||F(root)||_inf
+        double              elapsed              = 0.0;
+
+        bool converged() const { return status == RootStatus::Converged; }
+    };
+
+    template <VectorFunction F>
+    SystemResult newton_system(const F& func, std::vector<double> initial, double tolerance, int iterations, int refresh = 1);
+
+    template <VectorFunction F>
+    SystemResult broyden_method(const F& func, std::vector<double> initial, double tolerance, int iterations, int restart = 20);
 
 
     // Funciones segundo corte
 
-    Matrix regressive_substitution(Matrix matrix);
-    Matrix gaussian_elimination_step(Matrix matrix);
-    Matrix gaussian_elimination_with_regressive_substitution(Matrix matrix);
-    void   lu_factorization(Matrix A, Matrix& L, Matrix& U);
-    Matrix lu_substitution(Matrix matrix);
-    Matrix gauss_seidel(Matrix matrix, Matrix initial, double tolerance, int iterations);
+    // Reciben una Matrix o cualquier vista (un bloque [A|b] de una matriz mayor, ...)
+    Matrix regressive_substitution(ConstMatrixView matrix);
+    Matrix gaussian_elimination_step(ConstMatrixView matrix);
+    Matrix gaussian_elimination_with_regressive_substitution(ConstMatrixView matrix);
+    void   lu_factorization(ConstMatrixView A, Matrix& L, Matrix& U);
+    Matrix lu_substitution(ConstMatrixView matrix);
+    bool   lu_decompose(std::vector<double>& a, int n, std::vector<int>& pivots);
+    bool   lu_decompose(double* a, int n, int lda, std::vector<int>& pivots, int threads = 0);
+    void   lu_solve(const std::vector<double>& lu, int n, const std::vector<int>& pivots, double* b);
+    void   lu_solve(const double* lu, int n, int lda, const std::vector<int>& pivots, double* b);
+    Matrix gauss_seidel(ConstMatrixView matrix, ConstMatrixView initial, double tolerance, int iterations);
+
+    // -----------------------------------------------------------------
+    //  Muchos sistemas pequeños a la vez (lotes en formato SoA)
+    //
+    //  count sistemas aumentados [A|b] de n×(n+1), intercalados: el
+    //  elemento (i, j) del sistema k está en
+    //      augmented[(i * (n + 1) + j) * count + k]
+    //  y la solución x_i del sistema k queda en solutions[i * count + k].
+    //  Así cada paso de la eliminación es la misma operación sobre
+    //  sistemas contiguos en memoria, que el compilador vectoriza (un
+    //  sistema por carril SIMD), y los bloques de sistemas se reparten
+    //  entre hilos con parallel_for (threads = 0: todos los núcleos).
+    //
+    //  Usa las mismas reglas que
+    //  gaussian_elimination_with_regressive_substitution (primer pivote
+    //  con |a_pi| > 1e-12, intercambio de filas, sustitución regresiva),
+    //  elegidas carril por carril sin saltos, así que cada solución es
+    //  la misma que daría ese método. Un sistema sin solución única queda
+    //  con x = 0 y, si se pasa singular, con singular[k] = 1. Devuelve
+    //  cuántos sistemas fallaron.
+    // -----------------------------------------------------------------
+
+    int    solve_batched(int n, std::size_t count, const double* augmented, double* solutions,
+                         unsigned char* singular = nullptr, int threads = 0);
+    std::vector<double> solve_batched(int n, std::size_t count, const std::vector<double>& augmented, int threads = 0);
+
+    // -----------------------------------------------------------------
+    //  LUDecomposition: PA = LU factorizada una sola vez
+    //
+    //  Guarda el factor empaquetado de lu_decompose (L bajo la diagonal
+    //  con unos implícitos, U en la diagonal y arriba) y los pivotes, así
+    //  que cada sistema nuevo cuesta O(n²) en vez de O(n³):
+    //
+    //      LUDecomposition lu(A);
+    //      for (const Matrix& b : rhs) x = lu.solve(b);
+    //
+    //  A puede ser una vista (aug.block(0, 0, n, n)): se copia una sola
+    //  vez, directo al almacenamiento del factor.
+    //
+    //  solve(B) resuelve todas las columnas de B (n×k) de una pasada,
+    //  repartidas entre hilos si son muchas. Si A es singular (pivote
+    //  bajo 1e-12) singular() es true, determinant() da 0 y solve/inverse
+    //  avisan por std::cerr y devuelven ceros.
+    // -----------------------------------------------------------------
+
+    class LUDecomposition {
+    private:
+        Matrix           lu;
+        std::vector<int> pivots;
+        bool             failed = true;
+    public:
+        LUDecomposition                 ();
+        LUDecomposition                 (ConstMatrixView A, int threads = 0);
+        bool    singular                () const;
+        int     size                    () const;
+        const std::vector<int>& permutation() const;   // pivots[j]: fila intercambiada con j en el paso j
+        Matrix  lower                   () const;
+        Matrix  upper                   () const;
+        Matrix  solve                   (ConstMatrixView B, int threads = 0) const;
+        std::vector<double> solve       (const std::vector<double>& b) const;
+        void    solve_in_place          (double* b) const;
+        double  determinant             () const;
+        Matrix  inverse                 (int threads = 0) const;
+    };
 
     // Funciones segundo porte parte 2
-    double inferior_sums(Function func, double a, double b, int n);
-    double superior_sums(Function func, double a, double b, int n);
-    double trapezoidal_rule(Function func, double a, double b, int n);
-    double simpson_rule(Function func, double a, double b, int n);
+    template <Evaluable F> double inferior_sums(const F& func, double a, double b, int n);
+    template <Evaluable F> double superior_sums(const F& func, double a, double b, int n);
+    template <Evaluable F> double trapezoidal_rule(const F& func, double a, double b, int n);
+    template <Evaluable F> double simpson_rule(const F& func, double a, double b, int n);
+
+    // =====================================================================
+    //  Implementación de las plantillas
+    // =====================================================================
+
+    // -----------------------------------------------------------------
+    //  Contabilidad común de los métodos de ceros: cuenta evaluaciones de
+    //  f y de f', mide el tiempo desde la construcción y arma el
+    //  RootResult final. El residuo es |f(root)|.
+    // -----------------------------------------------------------------
+
+    template <typename F>
+    class RootCounter {
+        const F&                              func;
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        RootResult result;
+
+        explicit RootCounter(const F& func) : func(func), start(std::chrono::steady_clock::now()) {}
+
+        double operator()(double x)
+        {
+            if constexpr (Evaluable<F>)
+            {
+                result.evaluations++;
+                return evaluate_at(func, x);
+            }
+            else
+            {
+                double fx, dfx;
+                with_derivative(x, fx, dfx);
+                return fx;
+            }
+        }
+
+        void with_derivative(double x, double& fx, double& dfx)
+        {
+            result.evaluations++;
+            result.derivative_evaluations++;
+            evaluate_at_with_derivative(func, x, fx, dfx);
+        }
+
+        RootResult finish(RootStatus status, double root, double froot, int iterations)
+        {
+            result.status     = status;
+            result.root       = root;
+            result.residual   = std::abs(froot);
+            result.iterations = iterations;
+            result.elapsed    = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            return result;
+        }
+    };
+
+    template <Evaluable F>
+    RootResult bisection(const F& func, double point_a, double point_b, double tolerance, int iterations) {
+        RootCounter f(func);
+        // f(a) se arrastra entre iteraciones: una sola evaluación nueva por paso
+        double fa = f(point_a);
+        double fb = f(point_b);
+        if (fa == 0) return f.finish(RootStatus::Converged, point_a, fa, 0);
+        if (fb == 0) return f.finish(RootStatus::Converged, point_b, fb, 0);
+        if ((fa * fb) > 0) return f.finish(RootStatus::NoSignChange, NAN, NAN, 0);
+        double p = point_a;
+        double fp = fa;
+        for (int i = 0; i < iterations; i++){
+            p = point_a + ((point_b - point_a) / 2);
+            fp = f(p);
+            if (fp == 0 || ((point_b - point_a) / 2) < tolerance) return f.finish(RootStatus::Converged, p, fp, i + 1);
+            if ( (fa * fp) > 0 ) { point_a = p; fa = fp; }
+            else point_b = p;
+        }
+        return f.finish(RootStatus::MaxIterations, p, fp, iterations);
+    }
+
+    template <Evaluable F>
+    RootResult fixed_point(const F& func, double initial_point, double tolerance, int iterations) {
+        RootCounter f(func);
+        double point = initial_point;
+        double f_point = f(point);
+        double next_point;
+        double f_next;
+        for (int i = 0; i < iterations; i++){
+            next_point = point - f_point;
+            f_next = f(next_point);
+            if (f_next == 0 || std::abs(next_point - point) < tolerance)
+                return f.finish(RootStatus::Converged, next_point, f_next, i + 1);
+            point = next_point;
+            f_point = f_next;
+        }
+        return f.finish(RootStatus::MaxIterations, point, f_point, iterations);
+    }
+
+    template <Evaluable F>
+    RootResult fake_position(const F& func, double point_a, double point_b, double tolerance, int iterations) {
+        RootCounter f(func);
+        // f(a) y f(b) se arrastran: el extremo que no cambia no se reevalúa
+        double fa = f(point_a);
+        double fb = f(point_b);
+        if ((fa * fb) > 0) return f.finish(RootStatus::NoSignChange, NAN, NAN, 0);
+        double p = point_a;
+        double fp = fa;
+        for (int i = 0; i < iterations; i++) {
+            p = ((point_a * fb) - (point_b * fa) ) / (fb - fa);
+            fp = f(p);
+            if (fp == 0) return f.finish(RootStatus::Converged, p, fp, i + 1);
+            if ( (fp * fa) < 0) {
+                if (NumericalAnalysis::evaluate_tolerance(point_b, p, tolerance)) return f.finish(RootStatus::Converged, p, fp, i + 1);
+                point_b = p;
+                fb = fp;
+            }
+            else if ( (fp * fb) < 0) {
+                if (NumericalAnalysis::evaluate_tolerance(point_a, p, tolerance)) return f.finish(RootStatus::Converged, p, fp, i + 1);
+                point_a = p;
+                fa = fp;
+            }
+        }
+        return f.finish(RootStatus::MaxIterations, p, fp, iterations);
+    }
+
+    template <Differentiable F>
+    RootResult newton_raphson(const F& func, double initial_point, double tolerance, int iterations){
+        RootCounter f(func);
+        double point = initial_point;
+        double next_point;
+        double fx, dfx;
+        for (int i = 0; i < iterations; i++){
+            f.with_derivative(point, fx, dfx);
+            if (std::abs(dfx) < 1e-12) return f.finish(RootStatus::ZeroDerivative, point, fx, i);
+            next_point = point - (fx / dfx);
+            if (std::abs(next_point - point) < tolerance)
+                return f.finish(RootStatus::Converged, next_point, f(next_point), i + 1);
+            point = next_point;
+        }
+        return f.finish(RootStatus::MaxIterations, point, f(point), iterations);
+    }
+
+    template <Evaluable F>
+    RootResult secant_method(const F& func, double point_a, double point_b, double tolerance, int iterations) {
+        RootCounter f(func);
+        // Entendemos como point_a = x(n-1), point_b = x(n) y p = x(n+1)
+        double fa = f(point_a);
+        double fb = f(point_b);
+        double p;
+        for (int i = 0; i < iterations; i++){
+            if (std::abs(fb - fa) < 1e-12) return f.finish(RootStatus::ZeroDerivative, point_b, fb, i);
+            p = ( (point_a * fb) - (point_b * fa) ) / (fb - fa);
+            if (NumericalAnalysis::evaluate_tolerance(point_b, p, tolerance))
+                return f.finish(RootStatus::Converged, p, f(p), i + 1);
+            point_a = point_b;
+            fa = fb;
+            point_b = p;
+            fb = f(p);
+        }
+        return f.finish(RootStatus::MaxIterations, point_b, fb, iterations);
+    }
+
+    // -----------------------------------------------------------------
+    //  Método de Brent (zeroin)
+    //
+    //  Mantiene un intervalo [b, c] con cambio de signo, b el mejor
+    //  iterado. Intenta interpolación cuadrática inversa (o secante si
+    //  solo hay dos puntos) y la acepta si cae dentro del intervalo y
+    //  reduce el paso respecto al de dos iteraciones atrás; si no, bisecta.
+    //  Converge superlinealmente sin perder la garantía de la bisección.
+    // -----------------------------------------------------------------
+
+    template <Evaluable F>
+    RootResult brent_method(const F& func, double point_a, double point_b, double tolerance, int iterations) {
+        RootCounter f(func);
+        double a = point_a, b = point_b;
+        double fa = f(a);
+        double fb = f(b);
+        if (fa == 0) return f.finish(RootStatus::Converged, a, fa, 0);
+        if (fb == 0) return f.finish(RootStatus::Converged, b, fb, 0);
+        if ((fa > 0) == (fb > 0)) return f.finish(RootStatus::NoSignChange, NAN, NAN, 0);
+
+        double c = b, fc = fb;
+        double d = 0.0, e = 0.0;
+        for (int i = 0; i < iterations; i++) {
+            if ((fb > 0) == (fc > 0)) {
+                c = a; fc = fa;
+                d = e = b - a;
+            }
+            if (std::abs(fc) < std::abs(fb)) {
+                a = b; b = c; c = a;
+                fa = fb; fb = fc; fc = fa;
+            }
+            double tol1 = 2.0 * 2.220446049250313e-16 * std::abs(b) + 0.5 * tolerance;
+            double xm = 0.5 * (c - b);
+            if (std::abs(xm) <= tol1 || fb == 0) return f.finish(RootStatus::Converged, b, fb, i);
+
+            if (std::abs(e) >= tol1 && std::abs(fa) > std::abs(fb)) {
+                double s = fb / fa, p, q;
+                if (a == c) {                       // secante
+                    p = 2.0 * xm * s;
+                    q = 1.0 - s;
+                } else {                            // cuadrática inversa
+                    double qa = fa / fc, r = fb / fc;
+                    p = s * (2.0 * xm * qa * (qa - r) - (b - a) * (r - 1.0));
+                    q = (qa - 1.0) * (r - 1.0) * (s - 1.0);
+                }
+                if (p > 0) q = -q;
+                p = std::abs(p);
+                if (2.0 * p < std::min(3.0 * xm * q - std::abs(tol1 * q), std::abs(e * q))) {
+                    e = d;
+                    d = p / q;
+                } else {
+                    d = xm;
+                    e = d;
+                }
+            } else {
+                d = xm;
+                e = d;
+            }
+            a = b;
+            fa = fb;
+            b += (std::abs(d) > tol1) ? d : std::copysign(tol1, xm);
+            fb = f(b);
+        }
+        return f.finish(RootStatus::MaxIterations, b, fb, iterations);
+    }
+
+    // -----------------------------------------------------------------
+    //  Posición falsa modificada (Illinois)
+    //
+    //  Igual que fake_position, pero si el mismo extremo se conserva dos
+    //  veces seguidas su valor de f se divide entre 2. Eso evita que un
+    //  extremo quede fijo (el estancamiento de Regula Falsi en funciones
+    //  convexas) y da convergencia superlineal.
+    // -----------------------------------------------------------------
+
+    template <Evaluable F>
+    RootResult illinois_method(const F& func, double point_a, double point_b, double tolerance, int iterations) {
+        RootCounter f(func);
+        double fa = f(point_a);
+        double fb = f(point_b);
+        if (fa == 0) return f.finish(RootStatus::Converged, point_a, fa, 0);
+        if (fb == 0) return f.finish(RootStatus::Converged, point_b, fb, 0);
+        if ((fa > 0) == (fb > 0)) return f.finish(RootStatus::NoSignChange, NAN, NAN, 0);
+
+        int side = 0;   // -1: se movió a, +1: se movió b
+        double p = point_a;
+        double fp = fa;
+        for (int i = 0; i < iterations; i++) {
+            double previous = p;
+            p = ((point_a * fb) - (point_b * fa)) / (fb - fa);
+            fp = f(p);
+            if (fp == 0) return f.finish(RootStatus::Converged, p, fp, i + 1);
+
+            if ((fp > 0) == (fb > 0)) {
+                point_b = p;
+                fb = fp;
+                if (side == +1) fa /= 2;
+                side = +1;
+            } else {
+                point_a = p;
+                fa = fp;
+                if (side == -1) fb /= 2;
+                side = -1;
+            }
+            if (std::abs(point_b - point_a) < tolerance || (i > 0 && std::abs(p - previous) < tolerance))
+                return f.finish(RootStatus::Converged, p, fp, i + 1);
+        }
+        return f.finish(RootStatus::MaxIterations, p, fp, iterations);
+    }
+
+    // -----------------------------------------------------------------
+    //  Método ITP (Interpolate, Truncate, Project — Oliveira y Takahashi)
+    //
+    //  Parte del punto de Regula Falsi, lo trunca hacia el punto medio
+    //  (k1 * (b-a)^k2) y lo proyecta a una bola alrededor del punto medio
+    //  cuyo radio garantiza no pasar de n_1/2 + n0 iteraciones, el
+    //  número que usaría la bisección más n0. Con k1 = 0.2 / (b-a),
+    //  k2 = 2 y n0 = 1 converge superlinealmente en funciones suaves y
+    //  nunca es mucho peor que la bisección.
+    // -----------------------------------------------------------------
+
+    template <Evaluable F>
+    RootResult itp_method(const F& func, double point_a, double point_b, double tolerance, int iterations) {
+        RootCounter f(func);
+        double a = std::min(point_a, point_b), b = std::max(point_a, point_b);
+        double fa = f(a);
+        double fb = f(b);
+        if (fa == 0) return f.finish(RootStatus::Converged, a, fa, 0);
+        if (fb == 0) return f.finish(RootStatus::Converged, b, fb, 0);
+        if ((fa > 0) == (fb > 0)) return f.finish(RootStatus::NoSignChange, NAN, NAN, 0);
+
+        const double eps = 0.5 * tolerance;
+        const double k1  = 0.2 / (b - a);
+        const int    n0  = 1;
+        int n_half = static_cast<int>(std::ceil(std::log2((b - a) / (2.0 * eps))));
+        int n_max  = std::max(n_half, 0) + n0;
+
+        int j = 0;
+        for (; j < iterations && b - a > 2.0 * eps; j++) {
+            double x_half = 0.5 * (a + b);
+            double r      = eps * std::ldexp(1.0, n_max - j) - 0.5 * (b - a);
+            // δ >= eps: cerca de la raíz k1*(b-a)^2 cae bajo el ulp y x_t
+            // repetiría el extremo ya evaluado sin achicar el intervalo
+            double delta  = std::max(k1 * (b - a) * (b - a), eps);
+
+            // Interpolación, truncamiento y proyección
+            double x_f   = (b * fa - a * fb) / (fa - fb);
+            double sigma = (x_half - x_f) >= 0 ? 1.0 : -1.0;
+            double x_t   = (delta <= std::abs(x_half - x_f)) ? x_f + sigma * delta : x_half;
+            double x     = (std::abs(x_t - x_half) <= r) ? x_t : x_half - sigma * r;
+
+            double fx = f(x);
+            if (fx == 0) return f.finish(RootStatus::Converged, x, fx, j + 1);
+            if ((fx > 0) == (fa > 0)) { a = x; fa = fx; }
+            else                      { b = x; fb = fx; }
+        }
+        // Dentro del intervalo final se devuelve el extremo con menor |f|
+        RootStatus status = (b - a > 2.0 * eps) ? RootStatus::MaxIterations : RootStatus::Converged;
+        if (std::abs(fa) < std::abs(fb)) return f.finish(status, a, fa, j);
+        return f.finish(status, b, fb, j);
+    }
+
+    constexpr std::size_t EVAL_BLOCK = 256;
+
+    // -----------------------------------------------------------------
+    //  Recorre los nodos x_i = a + i*h, con i de first a last, en bloques
+    //  de EVAL_BLOCK. Si F tiene evaluate_many (Function) el bloque se
+    //  evalúa de una vez; si no, punto a punto. visit(i0, fx, len) recibe
+    //  f(x_i0), ..., f(x_{i0+len-1}). Cada nodo se evalúa una sola vez.
+    // -----------------------------------------------------------------
+
+    template <Evaluable F, typename Visit>
+    void for_each_grid_block(const F& func, double a, double h, int first, int last, Visit visit)
+    {
+        double xs[EVAL_BLOCK];
+        double fx[EVAL_BLOCK];
+
+        for (int i0 = first; i0 <= last; i0 += static_cast<int>(EVAL_BLOCK))
+        {
+            std::size_t len = std::min<std::size_t>(EVAL_BLOCK, last - i0 + 1);
+            for (std::size_t k = 0; k < len; k++)
+                xs[k] = a + (i0 + static_cast<int>(k)) * h;
+            if constexpr (requires(std::span<const double> in, std::span<double> out) { func.evaluate_many(in, out); })
+                func.evaluate_many({xs, len}, {fx, len});
+            else
+                for (std::size_t k = 0; k < len; k++) fx[k] = evaluate_at(func, xs[k]);
+            visit(i0, fx, len);
+        }
+    }
+
+    template <Evaluable F>
+    double inferior_sums(const F& func, double a, double b, int n)
+    {
+        double dx = (b - a) / n;
+        double sum = 0.0;
+        double f_prev = 0.0;
+
+        for_each_grid_block(func, a, dx, 0, n,
+            [&](int i0, const double *fx, std::size_t len)
+            {
+                for (std::size_t k = 0; k < len; k++)
+                {
+                    if (i0 + k > 0) sum += std::min(f_prev, fx[k]);
+                    f_prev = fx[k];
+                }
+            });
+
+        return sum * dx;
+    }
+
+    template <Evaluable F>
+    double superior_sums(const F& func, double a, double b, int n)
+    {
+        double dx = (b - a) / n;
+        double sum = 0.0;
+        double f_prev = 0.0;
+
+        for_each_grid_block(func, a, dx, 0, n,
+            [&](int i0, const double *fx, std::size_t len)
+            {
+                for (std::size_t k = 0; k < len; k++)
+                {
+                    if (i0 + k > 0) sum += std::max(f_prev, fx[k]);
+                    f_prev = fx[k];
+                }
+            });
+
+        return sum * dx;
+    }
+
+    template <Evaluable F>
+    double trapezoidal_rule(const F& func, double a, double b, int n)
+    {
+        double h = (b - a) / n;
+        double s0 = evaluate_at(func, a) + evaluate_at(func, b);
+        double s1 = 0.0;
+
+        for_each_grid_block(func, a, h, 1, n - 1,
+            [&](int, const double *fx, std::size_t len)
+            {
+                for (std::size_t k = 0; k < len; k++) s1 += fx[k];
+            });
+
+        return (h / 2.0) * (s0 + 2.0 * s1);
+    }
+
+    template <Evaluable F>
+    double simpson_rule(const F& func, double a, double b, int n)
+    {
+        if (n <= 0 || n % 2 != 0)
+        {
+            std::cerr << "[simpson_rule] n debe ser un entero positivo par\n";
+            return -1;
+        }
+
+        double h = (b - a) / n;
+        double s0 = evaluate_at(func, a) + evaluate_at(func, b);
+        double s1 = 0.0; // Terminos con indice impar
+        double s2 = 0.0; // Terminos con indice par
+
+        for_each_grid_block(func, a, h, 1, n - 1,
+            [&](int i0, const double *fx, std::size_t len)
+            {
+                for (std::size_t k = 0; k < len; k++)
+                {
+                    if ((i0 + k) % 2 == 0) s2 += fx[k];
+                    else                   s1 += fx[k];
+                }
+            });
+
+        return (h / 3.0) * (s0 + 4.0 * s1 + 2.0 * s2);
+    }
+
+    // -----------------------------------------------------------------
+    //  Híbrido secante / bisección sobre un intervalo con cambio de signo
+    //  (fa * fb < 0). Da pasos de secante mientras el intervalo se reduzca
+    //  al menos a la mitad; si no, el siguiente paso es de bisección, así
+    //  que el ancho se divide entre dos al menos cada dos evaluaciones.
+    // -----------------------------------------------------------------
+
+    template <Evaluable F>
+    double refine_bracket(const F& func, double a, double b, double fa, double fb, double tolerance, int iterations)
+    {
+        double previous_width = b - a;
+        bool   bisect = false;
+        for (int i = 0; i < iterations; i++)
+        {
+            double p = bisect ? a + 0.5 * (b - a) : (a * fb - b * fa) / (fb - fa);
+            if (!(p > a && p < b)) p = a + 0.5 * (b - a);
+            double fp = evaluate_at(func, p);
+            if (fp == 0) return p;
+            if ((fp < 0) == (fa < 0)) { a = p; fa = fp; }
+            else                      { b = p; fb = fp; }
+
+            double width = b - a;
+            if (width <= tolerance) break;
+            bisect = width > 0.5 * previous_width;
+            previous_width = width;
+        }
+        return std::abs(fa) < std::abs(fb) ? a : b;
+    }
+
+    // Mínimo de |f| en [a, b] por sección dorada
+    template <Evaluable F>
+    double minimize_abs(const F& func, double a, double b, double tolerance, int iterations)
+    {
+        const double r = 0.6180339887498949;
+        double c = b - r * (b - a), d = a + r * (b - a);
+        double fc = std::abs(evaluate_at(func, c)), fd = std::abs(evaluate_at(func, d));
+        for (int i = 0; i < iterations && b - a > tolerance; i++)
+        {
+            if (fc < fd) { b = d; d = c; fd = fc; c = b - r * (b - a); fc = std::abs(evaluate_at(func, c)); }
+            else         { a = c; c = d; fc = fd; d = a + r * (b - a); fd = std::abs(evaluate_at(func, d)); }
+        }
+        return fc < fd ? c : d;
+    }
+
+    template <Evaluable F>
+    std::vector<double> find_all_roots(const F& func, double a, double b, const RootScanOptions& options)
+    {
+        if (options.subdivisions <= 0 || !(a < b))
+        {
+            std::cerr << "[find_all_roots] Se requiere a < b y subdivisions > 0\n";
+            return {};
+        }
+
+        // 1. Malla
+        std::size_t cells = static_cast<std::size_t>(options.subdivisions);
+        double h = (b - a) / cells;
+        std::vector<double> xs(cells + 1), fx(cells + 1);
+        for (std::size_t i = 0; i <= cells; i++) xs[i] = a + i * h;
+        xs[cells] = b;
+
+        parallel_for(cells + 1, [&](std::size_t begin, std::size_t end)
+        {
+            std::size_t len = end - begin;
+            if constexpr (requires(std::span<const double> in, std::span<double> out) { func.evaluate_many(in, out); })
+                func.evaluate_many({xs.data() + begin, len}, {fx.data() + begin, len});
+            else
+                for (std::size_t i = begin; i < end; i++) fx[i] = evaluate_at(func, xs[i]);
+        }, options.threads, EVAL_BLOCK);
+
+        // 2. Intervalos con raíz (cell: raíz en [x_i, x_{i+1}]) y tangencias (x_{i-1}, x_{i+1})
+        struct Candidate { std::size_t cell; bool tangency; };
+        std::vector<Candidate> candidates;
+        std::vector<double>    roots;
+        for (std::size_t i = 0; i <= cells; i++)
+        {
+            if (fx[i] == 0) { roots.push_back(xs[i]); continue; }
+            if (i < cells && fx[i + 1] != 0 && (fx[i] < 0) != (fx[i + 1] < 0))
+                candidates.push_back({i, false});
+            else if (options.tangencies && i > 0 && i < cells
+                     && (fx[i - 1] < 0) == (fx[i] < 0) && (fx[i + 1] < 0) == (fx[i] < 0)
+                     && std::abs(fx[i]) < std::abs(fx[i - 1]) && std::abs(fx[i]) <= std::abs(fx[i + 1]))
+                candidates.push_back({i, true});
+        }
+
+        // 3. Refinamiento en paralelo
+        std::vector<double> refined(candidates.size());
+        std::vector<char>   accepted(candidates.size(), 1);
+        parallel_for(candidates.size(), [&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t k = begin; k < end; k++)
+            {
+                std::size_t i = candidates[k].cell;
+                if (!candidates[k].tangency)
+                {
+                    refined[k] = refine_bracket(func, xs[i], xs[i + 1], fx[i], fx[i + 1],
+                                                options.tolerance, options.iterations);
+                    continue;
+                }
+                double x = minimize_abs(func, xs[i - 1], xs[i + 1], options.tolerance, options.iterations);
+                double f = evaluate_at(func, x);
+                refined[k]  = x;
+                accepted[k] = std::abs(f) <= options.tangency_tolerance;
+            }
+        }, options.threads);
+
+        for (std::size_t k = 0; k < candidates.size(); k++)
+            if (accepted[k]) roots.push_back(refined[k]);
+
+        std::sort(roots.begin(), roots.end());
+        std::vector<double> unique;
+        for (double r : roots)
+            if (unique.empty() || r - unique.back() > options.merge_tolerance) unique.push_back(r);
+        return unique;
+    }
+
+    // -----------------------------------------------------------------
+    //  Sistemas no lineales — implementación
+    // -----------------------------------------------------------------
+
+    inline double max_norm(const std::vector<double>& v)
+    {
+        double m = 0.0;
+        for (double e : v) m = std::max(m, std::abs(e));
+        return m;
+    }
+
+    // J (n×n por filas) en x; fx = F(x) ya calculado (lo usan las diferencias)
+    template <VectorFunction F>
+    void system_jacobian(const F& func, const std::vector<double>& x, const std::vector<double>& fx,
+                         std::vector<double>& J, SystemResult& result)
+    {
+        const int n = static_cast<int>(x.size());
+        J.assign(static_cast<std::size_t>(n) * n, 0.0);
+        result.jacobian_evaluations++;
+
+        if constexpr (requires(const std::vector<Dual>& d) { { func(d) } -> std::convertible_to<std::vector<Dual>>; })
+        {
+            std::vector<Dual> xd(n);
+            for (int i = 0; i < n; i++) xd[i] = {x[i], 0.0};
+            for (int j = 0; j < n; j++)
+            {
+                xd[j].derivative = 1.0;
+                std::vector<Dual> fd = func(xd);
+                xd[j].derivative = 0.0;
+                for (int i = 0; i < n; i++) J[i * n + j] = fd[i].derivative;
+            }
+        }
+        else
+        {
+            std::vector<double> xh = x;
+            for (int j = 0; j < n; j++)
+            {
+                double h = 1.4901161193847656e-08 * std::max(1.0, std::abs(x[j]));   // sqrt(eps)
+                xh[j] = x[j] + h;
+                h = xh[j] - x[j];                                                    // paso representable
+                std::vector<double> fh = func(xh);
+                result.evaluations++;
+                xh[j] = x[j];
+                for (int i = 0; i < n; i++) J[i * n + j] = (fh[i] - fx[i]) / h;
+            }
+        }
+    }
+
+    template <VectorFunction F>
+    SystemResult newton_system(const F& func, std::vector<double> initial, double tolerance, int iterations, int refresh)
+    {
+        auto start = std::chrono::steady_clock::now();
+        SystemResult result;
+        auto finish = [&](RootStatus status, std::vector<double> x, const std::vector<double>& fx, int i)
+        {
+            result.status     = status;
+            result.root       = std::move(x);
+            result.residual   = max_norm(fx);
+            result.iterations = i;
+            result.elapsed    = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            return result;
+        };
+
+        const int n = static_cast<int>(initial.size());
+        std::vector<double> x = std::move(initial);
+        std::vector<double> fx = func(x);
+        result.evaluations++;
+        if (static_cast<int>(fx.size()) != n || refresh < 1)
+        {
+            std::cerr << "[newton_system] F debe ser de R^n en R^n y refresh >= 1\n";
+            return finish(RootStatus::InvalidInput, x, fx, 0);
+        }
+
+        std::vector<double> J, dx(n);
+        std::vector<int>    pivots;
+        for (int i = 0; i < iterations; i++)
+        {
+            if (max_norm(fx) == 0.0) return finish(RootStatus::Converged, x, fx, i);
+            if (i % refresh == 0)
+            {
+                system_jacobian(func, x, fx, J, result);
+                result.factorizations++;
+                if (!lu_decompose(J, n, pivots)) return finish(RootStatus::ZeroDerivative, x, fx, i);
+            }
+            for (int k = 0; k < n; k++) dx[k] = -fx[k];
+            lu_solve(J, n, pivots, dx.data());
+            for (int k = 0; k < n; k++) x[k] += dx[k];
+            fx = func(x);
+            result.evaluations++;
+            if (max_norm(dx) < tolerance) return finish(RootStatus::Converged, x, fx, i + 1);
+        }
+        return finish(RootStatus::MaxIterations, x, fx, iterations);
+    }
+
+    template <VectorFunction F>
+    SystemResult broyden_method(const F& func, std::vector<double> initial, double tolerance, int iterations, int restart)
+    {
+        auto start = std::chrono::steady_clock::now();
+        SystemResult result;
+        auto finish = [&](RootStatus status, std::vector<double> x, const std::vector<double>& fx, int i)
+        {
+            result.status     = status;
+            result.root       = std::move(x);
+            result.residual   = max_norm(fx);
+            result.iterations = i;
+            result.elapsed    = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            return result;
+        };
+
+        const int n = static_cast<int>(initial.size());
+        std::vector<double> x = std::move(initial);
+        std::vector<double> fx = func(x);
+        result.evaluations++;
+        if (static_cast<int>(fx.size()) != n)
+        {
+            std::cerr << "[broyden_method] F debe ser de R^n en R^n\n";
+            return finish(RootStatus::InvalidInput, x, fx, 0);
+        }
+
+        // H_k = (I + u_{k-1} s_{k-1}^T) ... (I + u_0 s_0^T) J_0^{-1}; J_0^{-1} es el factor LU
+        std::vector<double>              J;
+        std::vector<int>                 pivots;
+        std::vector<std::vector<double>> us, ss;
+        auto refactor = [&]()
+        {
+            system_jacobian(func, x, fx, J, result);
+            result.factorizations++;
+            us.clear();
+            ss.clear();
+            return lu_decompose(J, n, pivots);
+        };
+        auto apply_inverse = [&](std::vector<double>& v)
+        {
+            lu_solve(J, n, pivots, v.data());
+            for (std::size_t k = 0; k < us.size(); k++)
+            {
+                double dot = 0.0;
+                for (int i = 0; i < n; i++) dot += ss[k][i] * v[i];
+                for (int i = 0; i < n; i++) v[i] += us[k][i] * dot;
+            }
+        };
+
+        if (!refactor()) return finish(RootStatus::ZeroDerivative, x, fx, 0);
+
+        std::vector<double> s(n), y(n), hy(n), x_new(n);
+        for (int i = 0; i < iterations; i++)
+        {
+            if (max_norm(fx) == 0.0) return finish(RootStatus::Converged, x, fx, i);
+
+            for (int k = 0; k < n; k++) s[k] = -fx[k];
+            apply_inverse(s);
+            for (int k = 0; k < n; k++) x_new[k] = x[k] + s[k];
+            std::vector<double> f_new = func(x_new);
+            result.evaluations++;
+            if (max_norm(s) < tolerance) return finish(RootStatus::Converged, x_new, f_new, i + 1);
+
+            // Sherman–Morrison: u = (s - H y) / (s^T H y)
+            for (int k = 0; k < n; k++) y[k] = f_new[k] - fx[k];
+            hy = y;
+            apply_inverse(hy);
+            double denominator = 0.0;
+            for (int k = 0; k < n; k++) denominator += s[k] * hy[k];
+
+            x.swap(x_new);
+            fx.swap(f_new);
+            if (static_cast<int>(us.size()) >= restart || std::abs(denominator) < 1e-14 * max_norm(s) * max_norm(hy))
+            {
+                if (!refactor()) return finish(RootStatus::ZeroDerivative, x, fx, i + 1);
+                continue;
+            }
+            std::vector<double> u(n);
+            for (int k = 0; k < n; k++) u[k] = (s[k] - hy[k]) / denominator;
+            us.push_back(std::move(u));
+            ss.push_back(s);
+        }
+        return finish(RootStatus::MaxIterations, x, fx, iterations);
+    }
 }
 
-#endif 
\ No newline at end of file
+#endif
@@ -0,0 +1,324 @@
+#ifndef SMALLMATRIX_H
+#define SMALLMATRIX_H
+
+#include "numericalanalysis.h"
+
+#include <array>
+#include <cmath>
+#include <initializer_list>
+#include <iostream>
+#include <type_traits>
+#include <utility>
+
+// ---------------------------------------------------------------------
+//  Matrices de tamaño fijo (sistemas pequeños, 2×2 a 8×8)
+//
+//      SmallMatrix<3, 4> aug(Matrix("test_lu.txt"));      // [A|b]
+//      SmallMatrix<3, 1> x = lu_substitution(aug);
+//
+//      SmallMatrix<3, 3> A = {4, 1, 0,  1, 4, 1,  0, 1, 4};
+//      SmallLU<3> lu(A);   x = lu.solve(b);   double d = lu.determinant();
+//
+//  Las dimensiones son parámetros de la plantilla y los datos viven en
+//  la pila (un std::array por filas), así que no hay reservas de
+//  memoria. Los bucles de LU, sustitución, producto, inversa y
+//  determinante se desenrollan al compilar (small_unrolled), de modo
+//  que resolver un 3×3 es una secuencia de unas decenas de operaciones
+//  sin saltos de bucle. La LU usa la misma regla que lu_decompose
+//  (pivoteo parcial por el máximo, singular si el pivote cae bajo
+//  1e-12) y los mismos avisos y ceros que LUDecomposition.
+//
+//  Con Matrix se pasa en ambos sentidos sin adaptadores: SmallMatrix se
+//  convierte sola en ConstMatrixView/MatrixView (sirve en gemm,
+//  LUDecomposition y los sistemas lineales), to_matrix() da una Matrix
+//  y SmallMatrix<R, C>(v) copia cualquier Matrix o vista de R×C.
+// ---------------------------------------------------------------------
+
+// Los núcleos piden al compilador que inline todas las lambdas del
+// desenrollado; con -O2 a secas GCC deja llamadas sueltas y el 3×3 tarda
+// el triple.
+#if defined(__GNUC__)
+#define NA_SMALL_KERNEL __attribute__((flatten))
+#else
+#define NA_SMALL_KERNEL
+#endif
+
+namespace NumericalAnalysis {
+
+    // body(i) para i = 0 .. N-1, con i constante de compilación
+    template <int N, typename Body>
+    constexpr void small_unrolled(Body&& body)
+    {
+        [&]<int... I>(std::integer_sequence<int, I...>)
+        {
+            (body(std::integral_constant<int, I>{}), ...);
+        }(std::make_integer_sequence<int, N>{});
+    }
+
+    template <int R, int C>
+    class SmallMatrix {
+        static_assert(R > 0 && C > 0, "SmallMatrix needs positive dimensions");
+    private:
+        std::array<double, R * C> values{};
+    public:
+        constexpr SmallMatrix() = default;
+
+        // Valores por filas; si faltan, el resto queda en 0
+        constexpr SmallMatrix(std::initializer_list<double> list)
+        {
+            int k = 0;
+            for (double v : list)
+                if (k < R * C) values[k++] = v;
+        }
+
+        explicit SmallMatrix(ConstMatrixView m)
+        {
+            if (m.getRows() != R || m.getCols() != C)
+            {
+                std::cerr << "[SmallMatrix] Se esperaba una matriz de " << R << "x" << C
+                          << ", se recibió " << m.getRows() << "x" << m.getCols() << "\n";
+                return;
+            }
+            for (int i = 0; i < R; i++)
+                for (int j = 0; j < C; j++) (*this)(i, j) = m(i, j);
+        }
+
+        static constexpr SmallMatrix identity() requires (R == C)
+        {
+            SmallMatrix I;
+            small_unrolled<R>([&](auto i) { I(i, i) = 1.0; });
+            return I;
+        }
+
+        static constexpr int getRows() { return R; }
+        static constexpr int getCols() { return C; }
+
+        constexpr double& operator()(int i, int j)
+        {
+            NA_MATRIX_CHECK(i >= 0 && i < R && j >= 0 && j < C);
+            return values[i * C + j];
+        }
+        constexpr double operator()(int i, int j) const
+        {
+            NA_MATRIX_CHECK(i >= 0 && i < R && j >= 0 && j < C);
+            return values[i * C + j];
+        }
+
+        double*         data        ()       { return values.data(); }
+        const double*   data        () const { return values.data(); }
+        MatrixView      view        ()       { return MatrixView(values.data(), R, C, C); }
+        ConstMatrixView view        () const { return ConstMatrixView(values.data(), R, C, C); }
+        operator MatrixView         ()       { return view(); }
+        operator ConstMatrixView    () const { return view(); }
+        Matrix          to_matrix   () const { return Matrix(view()); }
+
+        constexpr SmallMatrix<C, R> transpose() const
+        {
+            SmallMatrix<C, R> T;
+            small_unrolled<R>([&](auto i) { small_unrolled<C>([&](auto j) { T(j, i) = (*this)(i, j); }); });
+            return T;
+        }
+
+        constexpr SmallMatrix& operator+=(const SmallMatrix& other)
+        {
+            small_unrolled<R * C>([&](auto k) { values[k] += other.values[k]; });
+            return *this;
+        }
+        constexpr SmallMatrix& operator-=(const SmallMatrix& other)
+        {
+            small_unrolled<R * C>([&](auto k) { values[k] -= other.values[k]; });
+            return *this;
+        }
+        constexpr SmallMatrix& operator*=(double factor)
+        {
+            small_unrolled<R * C>([&](auto k) { values[k] *= factor; });
+            return *this;
+        }
+    };
+
+    template <int R, int C>
+    constexpr SmallMatrix<R, C> operator+(SmallMatrix<R, C> a, const SmallMatrix<R, C>& b) { return a += b; }
+
+    template <int R, int C>
+    constexpr SmallMatrix<R, C> operator-(SmallMatrix<R, C> a, const SmallMatrix<R, C>& b) { return a -= b; }
+
+    template <int R, int C>
+    constexpr SmallMatrix<R, C> operator*(SmallMatrix<R, C> a, double factor) { return a *= factor; }
+
+    template <int R, int C>
+    constexpr SmallMatrix<R, C> operator*(double factor, SmallMatrix<R, C> a) { return a *= factor; }
+
+    // Producto desenrollado: cada c_ij es una cadena de K multiplicaciones
+    template <int R, int K, int C>
+    NA_SMALL_KERNEL constexpr SmallMatrix<R, C> operator*(const SmallMatrix<R, K>& a, const SmallMatrix<K, C>& b)
+    {
+        SmallMatrix<R, C> c;
+        small_unrolled<R>([&](auto i)
+        {
+            small_unrolled<K>([&](auto k)
+            {
+                const double aik = a(i, k);
+                small_unrolled<C>([&](auto j) { c(i, j) += aik * b(k, j); });
+            });
+        });
+        return c;
+    }
+
+    // -----------------------------------------------------------------
+    //  SmallLU: PA = LU de una SmallMatrix<N, N>
+    //
+    //  Misma interfaz que LUDecomposition (singular, solve, determinant,
+    //  inverse) con todos los bucles desenrollados. El factor guarda L
+    //  bajo la diagonal (unos implícitos) y U en la diagonal y arriba.
+    // -----------------------------------------------------------------
+
+    template <int N>
+    class SmallLU {
+    private:
+        SmallMatrix<N, N>   lu;
+        std::array<int, N>  pivots{};
+        bool                failed = true;
+    public:
+        constexpr SmallLU() = default;
+
+        NA_SMALL_KERNEL explicit constexpr SmallLU(const SmallMatrix<N, N>& A) : lu(A), failed(false)
+        {
+            small_unrolled<N>([&](auto jj)
+            {
+                constexpr int J = decltype(jj)::value;
+                if (failed) return;
+
+                int    r      = J;
+                double maxVal = std::abs(lu(J, J));
+                small_unrolled<N - J - 1>([&](auto ii)
+                {
+                    constexpr int I = J + 1 + decltype(ii)::value;
+                    double val = std::abs(lu(I, J));
+                    if (val > maxVal) { maxVal = val; r = I; }
+                });
+                pivots[J] = r;
+                if (maxVal < 1e-12) { failed = true; return; }
+
+                if (r != J)
+                    small_unrolled<N>([&](auto k) { std::swap(lu(J, k), lu(r, k)); });
+
+                small_unrolled<N - J - 1>([&](auto ii)
+                {
+                    constexpr int I = J + 1 + decltype(ii)::value;
+                    const double mij = lu(I, J) / lu(J, J);
+                    lu(I, J) = mij;
+                    small_unrolled<N - J - 1>([&](auto kk)
+                    {
+                        constexpr int K = J + 1 + decltype(kk)::value;
+                        lu(I, K) -= mij * lu(J, K);
+                    });
+                });
+            });
+        }
+
+        constexpr bool singular() const { return failed; }
+        constexpr const std::array<int, N>& permutation() const { return pivots; }
+        constexpr const SmallMatrix<N, N>&  factor() const { return lu; }
+
+        // Todas las columnas de B a la vez
+        template <int K>
+        NA_SMALL_KERNEL constexpr SmallMatrix<N, K> solve(const SmallMatrix<N, K>& B) const
+        {
+            if (failed)
+            {
+                std::cerr << "[SmallLU::solve] Matriz singular, no se puede resolver\n";
+                return SmallMatrix<N, K>();
+            }
+            SmallMatrix<N, K> X = B;
+            small_unrolled<N>([&](auto j)
+            {
+                if (pivots[j] != j)
+                    small_unrolled<K>([&](auto c) { std::swap(X(j, c), X(pivots[j], c)); });
+            });
+            small_unrolled<N>([&](auto ii)                      // L y = P b
+            {
+                constexpr int I = decltype(ii)::value;
+                small_unrolled<I>([&](auto p)
+                {
+                    const double lip = lu(I, p);
+                    small_unrolled<K>([&](auto c) { X(I, c) -= lip * X(p, c); });
+                });
+            });
+            small_unrolled<N>([&](auto rr)                      // U x = y
+            {
+                constexpr int I = N - 1 - decltype(rr)::value;
+                small_unrolled<N - I - 1>([&](auto pp)
+                {
+                    constexpr int P = I + 1 + decltype(pp)::value;
+                    const double uip = lu(I, P);
+                    small_unrolled<K>([&](auto c) { X(I, c) -= uip * X(P, c); });
+                });
+                small_unrolled<K>([&](auto c) { X(I, c) /= lu(I, I); });
+            });
+            return X;
+        }
+
+        NA_SMALL_KERNEL constexpr double determinant() const
+        {
+            if (failed) return 0.0;
+            double det = 1.0;
+            small_unrolled<N>([&](auto j)
+            {
+                det *= lu(j, j);
+                if (pivots[j] != j) det = -det;
+            });
+            return det;
+        }
+
+        constexpr SmallMatrix<N, N> inverse() const { return solve(SmallMatrix<N, N>::identity()); }
+    };
+
+    // Determinante por la LU desenrollada para todo N (también 2×2 y 3×3):
+    // una forma cerrada no aplica la regla del pivote bajo 1e-12, y así da
+    // lo mismo que SmallLU y que Matrix::determinant
+    template <int N>
+    constexpr double determinant(const SmallMatrix<N, N>& A)
+    {
+        return SmallLU<N>(A).determinant();
+    }
+
+    template <int N>
+    constexpr SmallMatrix<N, N> inverse(const SmallMatrix<N, N>& A)
+    {
+        SmallLU<N> lu(A);
+        if (lu.singular())
+        {
+            std::cerr << "[inverse] Singular matrix, cannot invert\n";
+            return SmallMatrix<N, N>();
+        }
+        return lu.inverse();
+    }
+
+    template <int N, int K>
+    constexpr SmallMatrix<N, K> solve(const SmallMatrix<N, N>& A, const SmallMatrix<N, K>& B)
+    {
+        return SmallLU<N>(A).solve(B);
+    }
+
+    // Como lu_substitution, para [A|b] de N×(N+1) en la pila
+    template <int N>
+    NA_SMALL_KERNEL constexpr SmallMatrix<N, 1> lu_substitution(const SmallMatrix<N, N + 1>& augmented)
+    {
+        SmallMatrix<N, N> A;
+        SmallMatrix<N, 1> b;
+        small_unrolled<N>([&](auto i)
+        {
+            small_unrolled<N>([&](auto j) { A(i, j) = augmented(i, j); });
+            b(i, 0) = augmented(i, N);
+        });
+        SmallLU<N> lu(A);
+        if (lu.singular())
+        {
+            std::cerr << "[lu_substitution] Matriz singular, no se puede factorizar\n";
+            return SmallMatrix<N, 1>();
+        }
+        return lu.solve(b);
+    }
+}
+
+#endif
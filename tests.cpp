@@ -0,0 +1,1287 @@
+#include "tests.h"
+#include "numericalanalysis.h"
+#include "expressiontemplates.h"
+#include "smallmatrix.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// ---------------------------------------------------------------------
+//  Pruebas de comportamiento
+//
+//  Cada prueba compara un resultado de la biblioteca contra un valor
+//  cerrado o contra otro camino de cálculo que ya se considera bueno
+//  (evaluate contra evaluate_many, LU contra eliminación gaussiana...).
+//  Los fallos se reportan por std::cerr con el nombre del caso; al final
+//  se imprime el total y run_tests retorna cuántos fallaron. Los avisos
+//  "[función] ..." que aparecen en medio son de los casos que prueban
+//  entradas inválidas a propósito.
+// ---------------------------------------------------------------------
+
+static int checks_run    = 0;
+static int checks_failed = 0;
+
+static void check(bool ok, const std::string &what)
+{
+    checks_run++;
+    if (!ok)
+    {
+        checks_failed++;
+        std::cerr << "[test] FALLA: " << what << "\n";
+    }
+}
+
+// |got - expected| ≤ tolerance · max(1, |expected|)
+static void check_near(double got, double expected, double tolerance, const std::string &what)
+{
+    bool ok = std::abs(got - expected) <= tolerance * std::max(1.0, std::abs(expected));
+    check(ok, what + " (se obtuvo " + std::to_string(got) + ", se esperaba " + std::to_string(expected) + ")");
+}
+
+// ---------------------------------------------------------------------
+//  Function: términos compilados y llaves de coeff
+// ---------------------------------------------------------------------
+
+void test_function_program()
+{
+    NumericalAnalysis::Function f;
+    f.extract_expression("3x^2 + 2sin(x) - 5cos(x^2) + e^(2x) - 7");
+
+    for (double x : {-1.5, 0.0, 0.3, 2.0})
+    {
+        double expected = 3 * x * x + 2 * std::sin(x) - 5 * std::cos(x * x) + std::exp(2 * x) - 7;
+        check_near(f.evaluate(x), expected, 1e-12, "Function::evaluate en x = " + std::to_string(x));
+        double derivative = 6 * x + 2 * std::cos(x) + 10 * x * std::sin(x * x) + 2 * std::exp(2 * x);
+        check_near(f.derivate_evaluate(x), derivative, 1e-12, "Function::derivate_evaluate en x = " + std::to_string(x));
+    }
+
+    check(f.contains("x^2") && f.get("x^2") == 3.0f, "llave x^2 con coeficiente 3");
+    check(f.contains("sin(x^1)") && f.get("sin(x^1)") == 2.0f, "llave sin(x^1) con coeficiente 2");
+    check(!f.contains("tan(x^1)"), "llave inexistente tan(x^1)");
+
+    // update y add recompilan el programa
+    f.update("x^2", 1.0f);
+    f.add("x^3", 2.0f);
+    double x = 0.5;
+    double expected = x * x + 2 * x * x * x + 2 * std::sin(x) - 5 * std::cos(x * x) + std::exp(2 * x) - 7;
+    check_near(f.evaluate(x), expected, 1e-12, "Function::evaluate tras update/add");
+}
+
+// ---------------------------------------------------------------------
+//  evaluate_many: el lote debe coincidir con la evaluación punto a punto
+//  (incluye la cola que no llena un grupo SIMD y argumentos grandes que
+//  caen al camino de libm)
+// ---------------------------------------------------------------------
+
+void test_evaluate_many()
+{
+    const char *expressions[] = {
+        "2sin(x) + 3cos(x) - tan(x^2) + e^(-0.5x^2) + 4x^3",
+        "sin(x^3) - 5cos(x^3) + e^(3x)",
+        "x*e^(-x^2) + sin(2x + 1)/sqrt(x + 10)",
+    };
+
+    std::vector<double> xs;
+    for (int i = 0; i < 1003; i++) xs.push_back(-3.0 + 6.0 * i / 1002.0);
+    xs.push_back(0.0);
+    xs.push_back(-0.0);
+
+    for (const char *expression : expressions)
+    {
+        NumericalAnalysis::Function f;
+        f.extract_expression(expression);
+
+        std::vector<double> y(xs.size()), dy(xs.size());
+        f.evaluate_many(xs, y);
+        f.derivate_evaluate_many(xs, dy);
+
+        double worst = 0.0, worst_derivative = 0.0;
+        for (std::size_t i = 0; i < xs.size(); i++)
+        {
+            double fx = f.evaluate(xs[i]), dfx = f.derivate_evaluate(xs[i]);
+            worst            = std::max(worst, std::abs(y[i] - fx) / std::max(1.0, std::abs(fx)));
+            worst_derivative = std::max(worst_derivative, std::abs(dy[i] - dfx) / std::max(1.0, std::abs(dfx)));
+        }
+        check(worst < 1e-13, std::string("evaluate_many contra evaluate: ") + expression);
+        check(worst_derivative < 1e-12, std::string("derivate_evaluate_many contra derivate_evaluate: ") + expression);
+    }
+
+    // NaN e infinito pasan por libm y se propagan igual que en evaluate
+    NumericalAnalysis::Function f;
+    f.extract_expression("sin(x) + e^(x)");
+    std::vector<double> special = {NAN, INFINITY, -INFINITY, 800.0, 1e10}, out(special.size());
+    f.evaluate_many(special, out);
+    for (std::size_t i = 0; i < special.size(); i++)
+    {
+        double fx = f.evaluate(special[i]);
+        check((std::isnan(fx) && std::isnan(out[i])) || fx == out[i],
+              "evaluate_many con argumento especial " + std::to_string(special[i]));
+    }
+}
+
+// ---------------------------------------------------------------------
+//  Polinomios: Horner denso y coeficientes
+// ---------------------------------------------------------------------
+
+void test_polynomial_horner()
+{
+    NumericalAnalysis::Function f;
+    f.extract_expression("x^5 - 4x + 1 + 2x^2");
+    check(f.is_polynomial(), "x^5 - 4x + 1 + 2x^2 es polinomio");
+
+    std::vector<double> coefficients = f.polynomial_coefficients();
+    std::vector<double> expected     = {1, -4, 2, 0, 0, 1};
+    check(coefficients == expected, "coeficientes densos de x^5 - 4x + 1 + 2x^2");
+
+    for (double x : {-2.0, -0.5, 0.0, 1.25, 3.0})
+    {
+        check_near(f.evaluate(x), std::pow(x, 5) - 4 * x + 1 + 2 * x * x, 1e-13, "Horner en x = " + std::to_string(x));
+        double fx, dfx;
+        f.evaluate_with_derivative(x, fx, dfx);
+        check_near(dfx, 5 * std::pow(x, 4) - 4 + 4 * x, 1e-13, "Horner doble (derivada) en x = " + std::to_string(x));
+    }
+
+    NumericalAnalysis::Function g;
+    g.extract_expression("x^2 + sin(x)");
+    check(!g.is_polynomial() && g.polynomial_coefficients().empty(), "x^2 + sin(x) no es polinomio");
+}
+
+// ---------------------------------------------------------------------
+//  Diferenciación automática: duales y series de Taylor truncadas
+// ---------------------------------------------------------------------
+
+void test_automatic_differentiation()
+{
+    using NumericalAnalysis::Dual;
+
+    // f = sin(x^2) + e^(2x) - x/(1 + x^2)
+    NumericalAnalysis::Function f;
+    f.extract_expression("sin(x^2) + e^(2x) - x/(1 + x^2)");
+
+    for (double x : {-1.0, 0.0, 0.7, 1.9})
+    {
+        const double s = std::sin(x * x), c = std::cos(x * x), e = std::exp(2 * x), q = 1 + x * x;
+        const double d[4] = {
+            s + e - x / q,
+            2 * x * c + 2 * e - (1 - x * x) / (q * q),
+            2 * c - 4 * x * x * s + 4 * e - (2 * x * x * x - 6 * x) / (q * q * q),
+            -12 * x * s - 8 * x * x * x * c + 8 * e - 6 * (-x * x * x * x + 6 * x * x - 1) / (q * q * q * q),
+        };
+
+        Dual fx = f.evaluate(Dual{x, 1.0});
+        check_near(fx.value, d[0], 1e-12, "Dual: valor en x = " + std::to_string(x));
+        check_near(fx.derivative, d[1], 1e-12, "Dual: derivada en x = " + std::to_string(x));
+
+        double taylor[4];
+        f.evaluate_derivatives(x, 3, taylor);
+        for (int k = 0; k < 4; k++)
+            check_near(taylor[k], d[k], 1e-10, "evaluate_derivatives orden " + std::to_string(k) + " en x = " + std::to_string(x));
+    }
+
+    // Newton sobre un invocable genérico: la derivada sale de Dual
+    auto g = [](auto x) { return x * x * x - 2.0 * x - 5.0; };
+    NumericalAnalysis::RootResult r = NumericalAnalysis::newton_raphson(g, 2.0, 1e-12, 50);
+    check(r.converged(), "newton_raphson con lambda genérica converge");
+    check_near(r.root, 2.0945514815423265, 1e-12, "raíz de x^3 - 2x - 5");
+}
+
+// ---------------------------------------------------------------------
+//  Parser: literales, constantes y llaves escritas a mano
+// ---------------------------------------------------------------------
+
+// f(x) de la expresión, o NAN si extract_expression la rechaza
+static double parse_and_evaluate(const std::string &expression, double x)
+{
+    NumericalAnalysis::Function f;
+    try
+    {
+        f.extract_expression(expression);
+    }
+    catch (const std::invalid_argument &)
+    {
+        return NAN;
+    }
+    return f.evaluate(x);
+}
+
+void test_expression_parser()
+{
+    const double x = 2.0, e = std::exp(1.0);
+    const struct { const char *expression; double expected; } cases[] = {
+        {"1e5",                 1e5},
+        {"2.5e-3x",             2.5e-3 * x},
+        {"4E+2 - x",            400 - x},
+        {"2e^x",                2 * std::exp(x)},
+        {"2e - 3x",             2 * e - 3 * x},
+        {"3e",                  3 * e},
+        {".5x^2 + 1.",          0.5 * x * x + 1},
+        {"2(x + 1)^2",          2 * (x + 1) * (x + 1)},
+        {"-x^2",                -x * x},
+        {"2^-1 x",              0.5 * x},
+        {"sin(2x + 1)/sqrt(x)", std::sin(2 * x + 1) / std::sqrt(x)},
+        {"e^(-x^2) + ln(x)",    std::exp(-x * x) + std::log(x)},
+        {"pi x",                M_PI * x},
+    };
+    for (const auto &c : cases)
+        check_near(parse_and_evaluate(c.expression, x), c.expected, 1e-14, std::string("parser: \"") + c.expression + "\"");
+
+    for (const char *invalid : {"sin x", "2 +", "(x", "1e400", "3 $ x"})
+    {
+        bool rejected = false;
+        try
+        {
+            NumericalAnalysis::Function f;
+            f.extract_expression(invalid);
+        }
+        catch (const std::invalid_argument &)
+        {
+            rejected = true;
+        }
+        check(rejected, std::string("parser rechaza \"") + invalid + "\"");
+    }
+
+    // Llaves con la grafía de la versión anterior
+    NumericalAnalysis::Function f;
+    f.extract_expression("3e^(2.50x) + 2sin(x^2) - e^(-x^2) + e^(4) + 5x");
+    for (const char *key : {"exp(2.50x)", "exp(2.5x)", "exp(+2.5x)"})
+        check(f.get(key) == 3.0f, std::string("llave ") + key);
+    check(f.get("exp(-1x^2)") == -1.0f, "llave exp(-1x^2)");
+    check(f.get("exp(4.0)") == 1.0f, "llave exp(4.0)");
+    check(f.get("sin(x^02)") == 2.0f && f.get("x^01") == 5.0f, "llaves con ceros a la izquierda");
+}
+
+// ---------------------------------------------------------------------
+//  Simplificación de la cinta: plegados, términos semejantes, sin/cos
+//  compartidos y potencias anidadas que no caben en int
+// ---------------------------------------------------------------------
+
+void test_expression_simplifier()
+{
+    const double x = 0.8;
+    const struct { const char *expression; double expected; } cases[] = {
+        {"2sin(2x + 1) - 5sin(2x + 1)",          -3 * std::sin(2 * x + 1)},
+        {"sin(2x + 1)*cos(2x + 1) + cos(2x + 1)", std::sin(2 * x + 1) * std::cos(2 * x + 1) + std::cos(2 * x + 1)},
+        {"(x + 1)*(x + 1) - (x + 1)^2",          0.0},
+        {"((x + 1)^2)^3 + 0*sin(x) + 1*x",       std::pow(x + 1, 6) + x},
+        {"--(x + 1) - (x + 1)^1",                0.0},
+        {"x/(1 + x)^(-2)",                       x * (1 + x) * (1 + x)},
+    };
+    for (const auto &c : cases)
+        check_near(parse_and_evaluate(c.expression, x), c.expected, 1e-13, std::string("simplificador: \"") + c.expression + "\"");
+
+    // (a^m)^n con mn fuera de int: no se pliega y el resultado sigue siendo correcto
+    check_near(parse_and_evaluate("((x + 1)^100000)^100000", 0.0), 1.0, 0.0, "((x+1)^1e5)^1e5 en x = 0");
+    check_near(parse_and_evaluate("((x - 1)^99999)^99999", 0.0), -1.0, 0.0, "((x-1)^99999)^99999 en x = 0");
+    check(parse_and_evaluate("((x + 1)^100000)^100000", 0.5) == INFINITY, "((x+1)^1e5)^1e5 desborda a inf");
+}
+
+// ---------------------------------------------------------------------
+//  Expresiones estáticas: deben dar lo mismo que Function con el texto
+//  equivalente, en valor, derivada y dentro de los métodos de ceros
+// ---------------------------------------------------------------------
+
+void test_static_expressions()
+{
+    using namespace NumericalAnalysis::Static;
+    auto f = 3 * pow<2>(x) + sin(pow<3>(x)) - exp(-1.0 * x) / (1.0 + pow<2>(x));
+
+    NumericalAnalysis::Function g;
+    g.extract_expression("3x^2 + sin(x^3) - e^(-x)/(1 + x^2)");
+
+    for (double v : {-1.2, 0.0, 0.4, 2.5})
+    {
+        check_near(f.evaluate(v), g.evaluate(v), 1e-14, "estática contra Function en x = " + std::to_string(v));
+        check_near(f.derivate_evaluate(v), g.derivate_evaluate(v), 1e-13, "derivada estática en x = " + std::to_string(v));
+    }
+    check_near(pow<-2>(x).evaluate(2.0), 0.25, 0.0, "pow<-2>(x) en x = 2");
+
+    auto h = pow<3>(x) - 2.0 * x - 5.0;
+    NumericalAnalysis::RootResult r = NumericalAnalysis::newton_raphson(h, 2.0, 1e-12, 50);
+    check(r.converged(), "newton_raphson con expresión estática converge");
+    check_near(r.root, 2.0945514815423265, 1e-12, "raíz estática de x^3 - 2x - 5");
+}
+
+// ---------------------------------------------------------------------
+//  Métodos genéricos: lambdas, punteros a función y Function dan lo mismo
+// ---------------------------------------------------------------------
+
+static double cubic(double v) { return v * v * v - 2 * v - 5; }
+
+void test_generic_callables()
+{
+    using namespace NumericalAnalysis;
+    Function f;
+    f.extract_expression("x^3 - 2x - 5");
+    auto lambda = [](double v) { return v * v * v - 2 * v - 5; };
+
+    const double root = 2.0945514815423265;
+    check_near(bisection(f, 2.0, 3.0, 1e-12, 200).root,       root, 1e-11, "bisection con Function");
+    check_near(bisection(lambda, 2.0, 3.0, 1e-12, 200).root,  root, 1e-11, "bisection con lambda");
+    check_near(bisection(&cubic, 2.0, 3.0, 1e-12, 200).root,  root, 1e-11, "bisection con puntero a función");
+    check_near(secant_method(lambda, 2.0, 3.0, 1e-12, 100).root, root, 1e-11, "secant_method con lambda");
+
+    // Integrales con valor cerrado
+    auto sine = [](double v) { return std::sin(v); };
+    check_near(simpson_rule(sine, 0.0, M_PI, 100),     2.0, 1e-7, "simpson_rule de sin en [0, pi]");
+    check_near(trapezoidal_rule(sine, 0.0, M_PI, 1000), 2.0, 1e-5, "trapezoidal_rule de sin en [0, pi]");
+    check(inferior_sums(f, 2.0, 3.0, 1000) <= superior_sums(f, 2.0, 3.0, 1000), "sumas inferiores ≤ superiores");
+    // ∫_2^3 x^3 - 2x - 5 dx = 65/4 - 5 - 5
+    check_near(simpson_rule(f, 2.0, 3.0, 10), 6.25, 1e-12, "simpson_rule exacta en cúbicas");
+}
+
+// ---------------------------------------------------------------------
+//  CachedFunction y conteo de evaluaciones en los métodos de intervalo
+// ---------------------------------------------------------------------
+
+void test_evaluation_cache()
+{
+    using namespace NumericalAnalysis;
+    int calls = 0;
+    auto counted = [&calls](double v) { calls++; return std::cos(v) - v; };
+
+    CachedFunction<decltype(counted)> cached(counted);
+    double first = cached.evaluate(0.5);
+    double again = cached.evaluate(0.5);
+    check(first == again && calls == 1, "CachedFunction reutiliza la abscisa repetida");
+    check(cached.calls() == 2 && cached.hits() == 1 && cached.evaluations() == 1, "contadores de CachedFunction");
+    auto reciprocal = [](double v) { return 1.0 / v; };
+    CachedFunction<decltype(reciprocal)> signed_zero(reciprocal);
+    check(signed_zero.evaluate(0.0) > 0 && signed_zero.evaluate(-0.0) < 0, "0 y -0 no se confunden");
+
+    // Simpson con caché da lo mismo que sin ella
+    cached.clear();
+    check(simpson_rule(cached, 0.0, 1.0, 64) == simpson_rule(counted, 0.0, 1.0, 64), "simpson_rule con CachedFunction");
+
+    // bisection arrastra f(a): una evaluación nueva por iteración más las dos de los extremos
+    calls = 0;
+    RootResult r = bisection(counted, 0.0, 1.0, 1e-10, 200);
+    check(r.converged() && r.evaluations == calls, "RootResult::evaluations cuenta cada llamada");
+    check(r.evaluations == r.iterations + 2, "bisection: iteraciones + 2 evaluaciones");
+}
+
+// ---------------------------------------------------------------------
+//  Aritmética de intervalos: el encierro contiene todas las muestras, y
+//  isolate_roots no pierde raíces
+// ---------------------------------------------------------------------
+
+void test_interval_arithmetic()
+{
+    using NumericalAnalysis::Interval;
+
+    NumericalAnalysis::Function f;
+    f.extract_expression("sin(3x) + x^2 - e^(-x) + cos(x^2)/(2 + x)");
+
+    for (Interval box : {Interval(-1.0, -0.5), Interval(-0.1, 0.3), Interval(0.9, 2.7), Interval(5.0, 5.001)})
+    {
+        Interval enclosure = f.evaluate(box);
+        bool inside = true;
+        for (int i = 0; i <= 200; i++)
+        {
+            double v = box.lo + (box.hi - box.lo) * i / 200.0;
+            inside = inside && enclosure.contains(f.evaluate(v));
+        }
+        check(inside, "encierro de f en [" + std::to_string(box.lo) + ", " + std::to_string(box.hi) + "]");
+    }
+
+    Interval s = sin(Interval(1.0, 2.0));
+    check(s.contains(1.0) && s.lo <= std::sin(1.0), "sin([1, 2]) contiene el máximo en pi/2");
+    Interval q = pow(Interval(-2.0, 1.0), 2);
+    check(q.lo <= 0.0 && q.lo > -1e-300 && q.contains(4.0), "[-2, 1]^2 = [0, 4]");
+
+    // (x - 1)(x - 2)(x - 3): cada raíz queda en alguna caja
+    NumericalAnalysis::Function cubic;
+    cubic.extract_expression("x^3 - 6x^2 + 11x - 6");
+    std::vector<Interval> boxes = NumericalAnalysis::isolate_roots(cubic, 0.0, 4.0, 1e-6);
+    for (double root : {1.0, 2.0, 3.0})
+    {
+        bool found = false;
+        for (const Interval &b : boxes) found = found || b.contains(root);
+        check(found, "isolate_roots encierra la raíz " + std::to_string(root));
+    }
+    check(boxes.size() <= 6, "isolate_roots no deja cajas de sobra");
+}
+
+// ---------------------------------------------------------------------
+//  parallel_for y solve_roots: cada índice se procesa exactamente una
+//  vez (también anidado y con más hilos que núcleos), y el lote da lo
+//  mismo que resolver uno por uno
+// ---------------------------------------------------------------------
+
+void test_parallel_batch()
+{
+    using namespace NumericalAnalysis;
+
+    for (int threads : {0, 1, 3, 64})
+        for (std::size_t grain : {std::size_t(1), std::size_t(7)})
+        {
+            std::vector<std::atomic<int>> seen(1000);
+            parallel_for(seen.size(), [&](std::size_t begin, std::size_t end)
+            {
+                for (std::size_t i = begin; i < end; i++) seen[i]++;
+            }, threads, grain);
+            bool once = true;
+            for (const auto &count : seen) once = once && count == 1;
+            check(once, "parallel_for con threads = " + std::to_string(threads) + ", grain = " + std::to_string(grain));
+        }
+
+    std::atomic<long> total{0};
+    parallel_for(16, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; i++)
+            parallel_for(50, [&](std::size_t b, std::size_t e)
+            {
+                for (std::size_t j = b; j < e; j++) total += static_cast<long>(i * 50 + j);
+            });
+    });
+    check(total == 800L * 799L / 2, "parallel_for anidado");
+
+    Function f;
+    f.extract_expression("x^3 - 2x - 5");
+    std::vector<RootProblem> problems;
+    for (int i = 0; i < 40; i++)
+    {
+        RootProblem problem;
+        problem.function   = &f;
+        problem.method     = (i % 2 == 0) ? RootMethod::Bisection : RootMethod::NewtonRaphson;
+        problem.point_a    = 1.0 + 0.01 * i;
+        problem.point_b    = 3.0;
+        problem.tolerance  = 1e-12;
+        problem.iterations = 200;
+        problems.push_back(problem);
+    }
+    std::vector<RootResult> results = solve_roots(problems);
+    bool same = results.size() == problems.size();
+    for (std::size_t i = 0; same && i < problems.size(); i++)
+        same = results[i].root == solve_root(problems[i]).root && results[i].converged();
+    check(same, "solve_roots coincide con solve_root uno por uno");
+}
+
+// ---------------------------------------------------------------------
+//  find_all_roots: raíces simples, dobles (tangencias) y nodos exactos
+// ---------------------------------------------------------------------
+
+static bool same_roots(const std::vector<double> &got, const std::vector<double> &expected, double tolerance)
+{
+    if (got.size() != expected.size()) return false;
+    for (std::size_t i = 0; i < got.size(); i++)
+        if (std::abs(got[i] - expected[i]) > tolerance) return false;
+    return true;
+}
+
+void test_find_all_roots()
+{
+    using namespace NumericalAnalysis;
+
+    Function f;
+    f.extract_expression("sin(x)");
+    check(same_roots(find_all_roots(f, -0.5, 10.0), {0.0, M_PI, 2 * M_PI, 3 * M_PI}, 1e-10),
+          "find_all_roots de sin(x) en [-0.5, 10]");
+
+    // (x - 1)^2 (x + 2): raíz doble sin cambio de signo
+    Function g;
+    g.extract_expression("x^3 - 3x + 2");
+    check(same_roots(find_all_roots(g, -3.0, 3.0), {-2.0, 1.0}, 1e-6), "find_all_roots con raíz doble");
+    RootScanOptions no_tangencies;
+    no_tangencies.tangencies = false;
+    check(same_roots(find_all_roots(g, -3.0, 3.0, no_tangencies), {-2.0}, 1e-9), "sin tangencias se omite la raíz doble");
+
+    auto lambda = [](double v) { return std::cos(v) - v; };
+    check(same_roots(find_all_roots(lambda, -5.0, 5.0), {0.7390851332151607}, 1e-10), "find_all_roots con lambda");
+}
+
+// ---------------------------------------------------------------------
+//  Brent, Illinois e ITP: convergen donde bisection; en raíces simples
+//  evalúan menos que bisection y que fake_position, e ITP nunca pasa de
+//  las iteraciones de bisection más n0 = 1
+// ---------------------------------------------------------------------
+
+void test_bracketing_hybrids()
+{
+    using namespace NumericalAnalysis;
+    const struct { const char *expression; double a, b; bool simple; } problems[] = {
+        {"x^3 - 2x - 5", 2.0, 3.0, true},
+        {"cos(x) - x",   0.0, 1.0, true},
+        {"x^10 - 1",     0.0, 1.3, true},
+        {"e^(10x) - 2", -1.0, 1.0, true},
+        {"(x - 1)^5",    0.0, 3.0, false},
+    };
+    for (const auto &p : problems)
+    {
+        Function f;
+        f.extract_expression(p.expression);
+        RootResult reference = bisection(f, p.a, p.b, 1e-13, 500);
+        RootResult regula    = fake_position(f, p.a, p.b, 1e-13, 500);
+        for (int m = 0; m < 3; m++)
+        {
+            RootResult r = m == 0 ? brent_method(f, p.a, p.b, 1e-13, 500)
+                         : m == 1 ? illinois_method(f, p.a, p.b, 1e-13, 500)
+                                  : itp_method(f, p.a, p.b, 1e-13, 500);
+            const std::string name = m == 0 ? "brent" : m == 1 ? "illinois" : "itp";
+            check(r.converged() && std::abs(r.root - reference.root) < 1e-6, name + " converge en " + p.expression);
+            if (m == 2)
+                check(r.evaluations <= reference.evaluations + 2, "itp acotado por bisection en " + std::string(p.expression));
+            else if (p.simple)
+                check(r.evaluations <= reference.evaluations && r.evaluations <= regula.evaluations,
+                      name + " evalúa menos que bisection y fake_position en " + p.expression);
+        }
+    }
+
+    Function h;
+    h.extract_expression("x^2 + 1");
+    check(brent_method(h, -1.0, 2.0, 1e-12, 100).status == RootStatus::NoSignChange, "brent sin cambio de signo");
+    check(illinois_method(h, -1.0, 2.0, 1e-12, 100).status == RootStatus::NoSignChange, "illinois sin cambio de signo");
+    check(itp_method(h, -1.0, 2.0, 1e-12, 100).status == RootStatus::NoSignChange, "itp sin cambio de signo");
+}
+
+// ---------------------------------------------------------------------
+//  RootResult: cada método reporta el estado que corresponde
+// ---------------------------------------------------------------------
+
+void test_root_status()
+{
+    using namespace NumericalAnalysis;
+    Function no_root, line, parabola, cubic;
+    no_root.extract_expression("x^2 + 1");
+    line.extract_expression("x - 1");
+    parabola.extract_expression("x^2 - 2");
+    cubic.extract_expression("x^3 - 2x - 5");
+
+    check(bisection(no_root, -1.0, 2.0, 1e-12, 100).status == RootStatus::NoSignChange, "bisection sin cambio de signo");
+    check(fake_position(no_root, -1.0, 2.0, 1e-12, 100).status == RootStatus::NoSignChange, "fake_position sin cambio de signo");
+
+    RootResult at_end = bisection(line, 1.0, 3.0, 1e-12, 100);
+    check(at_end.converged() && at_end.root == 1.0 && at_end.iterations == 0, "bisection con raíz en el extremo");
+    RootResult exact = fake_position(line, 0.0, 3.0, 1e-12, 100);
+    check(exact.converged() && exact.root == 1.0 && exact.iterations == 1, "fake_position se detiene en un cero exacto");
+
+    RootResult capped = bisection(cubic, 2.0, 3.0, 1e-14, 5);
+    check(capped.status == RootStatus::MaxIterations && capped.iterations == 5, "bisection agota las iteraciones");
+    check(std::abs(capped.root - 2.0945514815423265) < 1.0 / 32, "MaxIterations deja la mejor aproximación");
+
+    check(newton_raphson(parabola, 0.0, 1e-12, 50).status == RootStatus::ZeroDerivative, "newton_raphson con f'(x0) = 0");
+    check(secant_method(parabola, -1.0, 1.0, 1e-12, 50).status == RootStatus::ZeroDerivative, "secant_method con pendiente nula");
+
+    RootResult newton = newton_raphson(parabola, 1.0, 1e-12, 50);
+    check(newton.converged() && std::abs(newton.root - std::sqrt(2.0)) < 1e-12, "newton_raphson converge a raíz de 2");
+    check(std::abs(newton.residual) < 1e-12 && newton.derivative_evaluations > 0, "newton_raphson reporta residuo y derivadas");
+
+    // fixed_point itera x - f(x): con f = x - cos(x) es x <- cos(x)
+    Function g;
+    g.extract_expression("x - cos(x)");
+    RootResult fixed = fixed_point(g, 0.5, 1e-12, 200);
+    check(fixed.converged() && std::abs(fixed.root - 0.7390851332151607) < 1e-10, "fixed_point converge");
+
+    for (RootStatus status : {RootStatus::Converged, RootStatus::MaxIterations, RootStatus::NoSignChange,
+                              RootStatus::ZeroDerivative, RootStatus::InvalidInput})
+        check(std::string(to_string(status)) != "desconocido", "to_string de cada RootStatus");
+}
+
+// ---------------------------------------------------------------------
+//  polynomial_roots: raíces reales, complejas conjugadas, nulas y
+//  polinomios de grado alto
+// ---------------------------------------------------------------------
+
+// Mismo multiconjunto de raíces (el orden por parte real no es estable
+// cuando una parte real es ruido de redondeo alrededor de 0)
+static bool same_complex_roots(std::vector<std::complex<double>> got,
+                               const std::vector<std::complex<double>> &expected, double tolerance)
+{
+    if (got.size() != expected.size()) return false;
+    for (std::complex<double> z : expected)
+    {
+        auto match = std::find_if(got.begin(), got.end(), [&](std::complex<double> w) { return std::abs(w - z) <= tolerance; });
+        if (match == got.end()) return false;
+        got.erase(match);
+    }
+    return true;
+}
+
+void test_polynomial_roots()
+{
+    using namespace NumericalAnalysis;
+    using complex = std::complex<double>;
+
+    check(same_complex_roots(polynomial_roots({-6, 11, -6, 1}), {1.0, 2.0, 3.0}, 1e-12), "raíces de (x-1)(x-2)(x-3)");
+    check(same_complex_roots(polynomial_roots({1, 0, 1}), {complex(0, -1), complex(0, 1)}, 1e-14), "raíces de x^2 + 1");
+    check(same_complex_roots(polynomial_roots({0, 0, -1, 0, 1}), {-1.0, 0.0, 0.0, 1.0}, 1e-14), "raíces nulas de x^4 - x^2");
+
+    // Wilkinson de grado 10: (x-1)(x-2)...(x-10)
+    std::vector<double> wilkinson = {1.0};
+    for (int r = 1; r <= 10; r++)
+    {
+        std::vector<double> next(wilkinson.size() + 1, 0.0);
+        for (std::size_t k = 0; k < wilkinson.size(); k++)
+        {
+            next[k + 1] += wilkinson[k];
+            next[k]     -= r * wilkinson[k];
+        }
+        wilkinson = next;
+    }
+    std::vector<complex> expected;
+    for (int r = 1; r <= 10; r++) expected.push_back(r);
+    check(same_complex_roots(polynomial_roots(wilkinson), expected, 1e-8), "raíces del polinomio de Wilkinson de grado 10");
+
+    Function f;
+    f.extract_expression("x^3 - 2x - 5");
+    std::vector<complex> roots = polynomial_roots(f);
+    bool residuals = roots.size() == 3;
+    for (complex z : roots) residuals = residuals && std::abs(z * z * z - 2.0 * z - 5.0) < 1e-12;
+    check(residuals, "polynomial_roots(Function) deja residuo pequeño");
+
+    Function g;
+    g.extract_expression("sin(x) + x");
+    check(polynomial_roots(g).empty(), "polynomial_roots rechaza una función no polinómica");
+}
+
+// ---------------------------------------------------------------------
+//  Sistemas no lineales: Newton (jacobiano por AD y por diferencias),
+//  Newton-cuerda y Broyden llegan a la misma solución
+// ---------------------------------------------------------------------
+
+void test_nonlinear_systems()
+{
+    using namespace NumericalAnalysis;
+
+    // x^2 + y^2 = 4,  e^x + y = 1  ->  (-1.8163..., 0.8374...)
+    auto generic = [](const auto &v)
+    {
+        using std::exp;
+        using T = std::decay_t<decltype(v[0])>;
+        return std::vector<T>{v[0] * v[0] + v[1] * v[1] - 4.0, exp(v[0]) + v[1] - 1.0};
+    };
+    auto plain = [](const std::vector<double> &v)
+    {
+        return std::vector<double>{v[0] * v[0] + v[1] * v[1] - 4.0, std::exp(v[0]) + v[1] - 1.0};
+    };
+
+    SystemResult reference = newton_system(generic, {-1.0, 1.0}, 1e-12, 50);
+    check(reference.converged() && reference.residual < 1e-10, "newton_system con jacobiano por AD");
+    check(reference.root.size() == 2 && std::abs(reference.root[0] * reference.root[0] + reference.root[1] * reference.root[1] - 4.0) < 1e-10,
+          "newton_system cumple x^2 + y^2 = 4");
+
+    const struct { const char *name; SystemResult result; } variants[] = {
+        {"newton_system por diferencias",  newton_system(plain, {-1.0, 1.0}, 1e-12, 50)},
+        {"newton_system cuerda",           newton_system(generic, {-1.0, 1.0}, 1e-12, 100, 5)},
+        {"broyden_method",                 broyden_method(plain, {-1.0, 1.0}, 1e-12, 100)},
+    };
+    for (const auto &v : variants)
+    {
+        bool same = v.result.converged() && v.result.root.size() == 2
+                 && std::abs(v.result.root[0] - reference.root[0]) < 1e-7
+                 && std::abs(v.result.root[1] - reference.root[1]) < 1e-7;
+        check(same, std::string(v.name) + " coincide con Newton");
+    }
+    check(variants[1].result.factorizations < variants[1].result.iterations, "la cuerda reutiliza factorizaciones");
+    check(variants[2].result.factorizations < variants[2].result.iterations, "broyden factoriza menos que una vez por iteración");
+
+    // Jacobiano exacto (AD) singular en el punto inicial
+    auto flat = [](const auto &v)
+    {
+        using T = std::decay_t<decltype(v[0])>;
+        return std::vector<T>{v[0] * v[0], v[1] * v[1] + 1.0};
+    };
+    check(newton_system(flat, {0.0, 0.0}, 1e-12, 20).status == RootStatus::ZeroDerivative, "newton_system con jacobiano singular");
+}
+
+// ---------------------------------------------------------------------
+//  continue_root: el barrido llega al extremo con Converged aunque to no
+//  sea representable en float, y se detiene en un pliegue
+// ---------------------------------------------------------------------
+
+void test_parameter_continuation()
+{
+    using namespace NumericalAnalysis;
+    Function f;
+    f.extract_expression("x^3 - 2x + 1");
+
+    // Rama negativa de x^3 - 2x + c, hacia abajo y hacia arriba; 0.7, 0.9,
+    // 0.3 y 1.3 no son float exactos (unos redondean hacia arriba y otros
+    // hacia abajo)
+    const struct { double from, to; } sweeps[] = {
+        {1.5, 0.7}, {1.5, 0.9}, {1.5, 0.3}, {1.5, -0.6}, {-0.6, 0.7}, {-0.6, 0.3}, {-0.6, 1.3},
+    };
+    for (const auto &sweep : sweeps)
+    {
+        const double c = sweep.from;
+        RootResult start = newton_raphson([c](auto x) { return x * x * x - 2.0 * x + c; }, -1.5, 1e-14, 50);
+        const double to = sweep.to;
+        ContinuationResult r = continue_root(f, "x^0", sweep.from, to, start.root);
+        check(r.converged(), "continue_root de " + std::to_string(sweep.from) + " a " + std::to_string(to) + " termina en Converged");
+        if (r.points.empty()) continue;
+        const ContinuationPoint &last = r.points.back();
+        check(last.parameter == static_cast<float>(to), "el último punto está en float(to) = " + std::to_string(to));
+        check(std::abs(last.root * last.root * last.root - 2 * last.root + last.parameter) < 1e-10,
+              "el último punto es raíz con p = " + std::to_string(to));
+    }
+
+    // Rama de sqrt(2) en c = 0: en c = (4/3) sqrt(2/3) ~ 1.0887 se junta con la
+    // otra raíz positiva (un pliegue) y no se puede seguir hasta c = 2
+    ContinuationResult fold = continue_root(f, "x^0", 0.0, 2.0, 1.0);
+    check(!fold.converged() && !fold.points.empty() && fold.points.back().parameter < 1.09, "continue_root se detiene en el pliegue");
+
+    check(continue_root(f, "x^7", 0.0, 1.0, 1.0).status == RootStatus::InvalidInput, "continue_root con llave inexistente");
+}
+
+// ---------------------------------------------------------------------
+//  Matrix: bloque contiguo con filas alineadas y sustitución hacia atrás
+//  (incluido el sistema vacío, que se rechaza)
+// ---------------------------------------------------------------------
+
+void test_matrix_storage()
+{
+    using namespace NumericalAnalysis;
+    for (int cols : {1, 7, 8, 9, 13})
+    {
+        Matrix m(5, cols);
+        check(m.stride() >= cols && m.stride() % 8 == 0, "stride múltiplo de 8 con " + std::to_string(cols) + " columnas");
+        bool aligned = true;
+        for (int i = 0; i < m.getRows(); i++)
+            aligned = aligned && reinterpret_cast<std::uintptr_t>(m.row(i)) % 64 == 0;
+        check(aligned, "todas las filas alineadas a 64 bytes con " + std::to_string(cols) + " columnas");
+    }
+
+    Matrix m({{1, 2, 3}, {4, 5, 6}});
+    check(m.row(1) == m.data() + m.stride() && m.row(1)[2] == 6 && m(0, 1) == 2, "row(i) = data() + i * stride()");
+    m.set(1, 0, -4);
+    check(m(1, 0) == -4 && m.get(1, 0) == -4, "set y get sobre el bloque contiguo");
+    check(m.get(2, 0) == 0.0 && m.get(0, 3) == 0.0, "get fuera de rango retorna 0");
+
+    Matrix copy = m;
+    copy(0, 0) = 10;
+    check(m(0, 0) == 1 && copy.data() != m.data(), "la copia no comparte almacenamiento");
+    Matrix moved = std::move(copy);
+    check(moved(0, 0) == 10 && moved(1, 2) == 6, "el movimiento conserva el contenido");
+
+    // Sistema triangular superior con solución conocida x = (1, -2, 3)
+    Matrix upper({{2, 1, -1, -3}, {0, 3, 2, 0}, {0, 0, 4, 12}});
+    Matrix x = regressive_substitution(upper);
+    check(x.getRows() == 3 && x.getCols() == 1, "regressive_substitution retorna n×1");
+    check_near(x(0, 0), 1.0, 1e-14, "regressive_substitution x1");
+    check_near(x(1, 0), -2.0, 1e-14, "regressive_substitution x2");
+    check_near(x(2, 0), 3.0, 1e-14, "regressive_substitution x3");
+
+    check(regressive_substitution(Matrix(0, 1)).getRows() == 0, "regressive_substitution rechaza el sistema vacío");
+    check(gaussian_elimination_with_regressive_substitution(Matrix(0, 1)).getRows() == 0, "gaussian_elimination rechaza el sistema vacío");
+    check(regressive_substitution(Matrix(3, 3)).getRows() == 3, "regressive_substitution rechaza una matriz no aumentada");
+}
+
+// ---------------------------------------------------------------------
+//  gemm: contra el producto ingenuo con k > KC (varios bloques de k y
+//  bordes que no llenan un tile), beta, y C solapada con A o con B
+// ---------------------------------------------------------------------
+
+static NumericalAnalysis::Matrix random_matrix(int rows, int cols, unsigned seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    NumericalAnalysis::Matrix m(rows, cols);
+    for (int i = 0; i < rows; i++)
+        for (int j = 0; j < cols; j++) m(i, j) = uniform(generator);
+    return m;
+}
+
+// alpha * A * B + beta * C con tres bucles
+static NumericalAnalysis::Matrix naive_gemm(double alpha, NumericalAnalysis::ConstMatrixView A, NumericalAnalysis::ConstMatrixView B,
+                                            double beta, NumericalAnalysis::ConstMatrixView C)
+{
+    NumericalAnalysis::Matrix result(A.getRows(), B.getCols());
+    for (int i = 0; i < A.getRows(); i++)
+        for (int j = 0; j < B.getCols(); j++)
+        {
+            double sum = 0.0;
+            for (int p = 0; p < A.getCols(); p++) sum += A(i, p) * B(p, j);
+            result(i, j) = alpha * sum + (beta == 0.0 ? 0.0 : beta * C(i, j));
+        }
+    return result;
+}
+
+static double max_difference(NumericalAnalysis::ConstMatrixView a, NumericalAnalysis::ConstMatrixView b)
+{
+    double worst = 0.0;
+    for (int i = 0; i < a.getRows(); i++)
+        for (int j = 0; j < a.getCols(); j++) worst = std::max(worst, std::abs(a(i, j) - b(i, j)));
+    return worst;
+}
+
+void test_gemm()
+{
+    using namespace NumericalAnalysis;
+    const struct { int m, n, k; } shapes[] = { {37, 29, 300}, {13, 17, 5}, {100, 40, 513}, {1, 1, 1} };
+    for (const auto &shape : shapes)
+    {
+        const std::string name = std::to_string(shape.m) + "x" + std::to_string(shape.k) + " * " +
+                                 std::to_string(shape.k) + "x" + std::to_string(shape.n);
+        Matrix A = random_matrix(shape.m, shape.k, 1);
+        Matrix B = random_matrix(shape.k, shape.n, 2);
+        Matrix C = random_matrix(shape.m, shape.n, 3);
+        Matrix expected = naive_gemm(1.5, A, B, 0.5, C);
+        gemm(1.5, A, B, 0.5, C);
+        check(max_difference(C, expected) < 1e-12 * shape.k, "gemm con beta = 0.5, " + name);
+
+        C.view().fill(NAN);
+        gemm(1.0, A, B, 0.0, C);
+        check(max_difference(C, naive_gemm(1.0, A, B, 0.0, C)) < 1e-12 * shape.k, "gemm con beta = 0 no lee C, " + name);
+    }
+
+    // Vistas con stride dentro de una matriz mayor
+    Matrix big = random_matrix(40, 40, 4);
+    Matrix out(30, 40);
+    out.view().fill(1.0);
+    gemm(1.0, big.block(3, 5, 10, 20), big.block(12, 1, 20, 7), 2.0, out.block(4, 6, 10, 7));
+    Matrix ones(10, 7);
+    ones.view().fill(1.0);
+    check(max_difference(out.block(4, 6, 10, 7), naive_gemm(1.0, big.block(3, 5, 10, 20), big.block(12, 1, 20, 7), 2.0, ones)) < 1e-12,
+          "gemm sobre bloques de matrices mayores");
+    check(out(3, 6) == 1.0 && out(4, 5) == 1.0 && out(14, 6) == 1.0 && out(4, 13) == 1.0, "gemm no escribe fuera del bloque de C");
+
+    // C es la misma matriz que A: X = X * B
+    Matrix X = random_matrix(20, 20, 5), Y = random_matrix(20, 20, 6);
+    Matrix expected = naive_gemm(1.0, X, Y, 0.0, X);
+    gemm(1.0, X, Y, 0.0, X);
+    check(max_difference(X, expected) < 1e-12, "gemm con C = A");
+
+    // C es un bloque que se solapa con A y con B sin empezar en la misma
+    // dirección; con m > MC los bloques de filas de A que se empaquetan
+    // después ya estarían pisados por C
+    Matrix M = random_matrix(160, 160, 7);
+    Matrix copy = M;
+    expected = naive_gemm(1.0, copy.block(1, 0, 150, 150), copy.block(0, 1, 150, 150), 1.0, copy.block(2, 2, 150, 150));
+    gemm(1.0, M.block(1, 0, 150, 150), M.block(0, 1, 150, 150), 1.0, M.block(2, 2, 150, 150));
+    check(max_difference(M.block(2, 2, 150, 150), expected) < 1e-11, "gemm con C solapada con A y B");
+
+    // Bloques disjuntos de la misma matriz: no hace falta copiar, pero el resultado es el mismo
+    M = copy;
+    expected = naive_gemm(1.0, copy.block(0, 0, 80, 80), copy.block(0, 80, 80, 80), 0.0, copy.block(80, 0, 80, 80));
+    gemm(1.0, M.block(0, 0, 80, 80), M.block(0, 80, 80, 80), 0.0, M.block(80, 0, 80, 80));
+    check(max_difference(M.block(80, 0, 80, 80), expected) < 1e-12, "gemm con bloques disjuntos de una matriz");
+
+    Matrix wrong(3, 3);
+    wrong.view().fill(7.0);
+    gemm(1.0, X, Y, 0.0, wrong);
+    check(wrong(0, 0) == 7.0, "gemm con dimensiones incompatibles no toca C");
+}
+
+// ---------------------------------------------------------------------
+//  LU por bloques: max |PA - LU| pequeño con n mayor que LU_BLOCK (varios
+//  paneles y bordes), el mismo factor con 1 hilo y con varios, y pivote
+//  nulo detectado en un panel que no es el primero
+// ---------------------------------------------------------------------
+
+// max |PA - LU| / max |A| para el factor empaquetado de lu_decompose
+static double lu_residual(const NumericalAnalysis::Matrix &A, const double *lu, int lda, const std::vector<int> &pivots)
+{
+    const int n = A.getRows();
+    NumericalAnalysis::Matrix PA = A;
+    for (int j = 0; j < n; j++)
+        if (pivots[j] != j) std::swap_ranges(PA.row(j), PA.row(j) + n, PA.row(pivots[j]));
+
+    double worst = 0.0, scale = 0.0;
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+        {
+            double sum = 0.0;
+            for (int p = 0; p <= std::min(i, j); p++)
+            {
+                const double l = (p == i) ? 1.0 : lu[static_cast<std::size_t>(i) * lda + p];
+                sum += l * lu[static_cast<std::size_t>(p) * lda + j];
+            }
+            worst = std::max(worst, std::abs(PA(i, j) - sum));
+            scale = std::max(scale, std::abs(A(i, j)));
+        }
+    return worst / scale;
+}
+
+void test_blocked_lu()
+{
+    using namespace NumericalAnalysis;
+    for (int n : {5, 128, 300})
+    {
+        Matrix A = random_matrix(n, n, 10 + n);
+        const int lda = n + 3;   // stride mayor que n, como un bloque de una matriz más grande
+        std::vector<double> a(static_cast<std::size_t>(n) * lda, 0.0);
+        for (int i = 0; i < n; i++) std::copy_n(A.row(i), n, a.data() + static_cast<std::size_t>(i) * lda);
+
+        std::vector<int> pivots;
+        check(lu_decompose(a.data(), n, lda, pivots), "lu_decompose factoriza una matriz aleatoria de " + std::to_string(n));
+        check(lu_residual(A, a.data(), lda, pivots) < 1e-14 * n, "max |PA - LU| pequeño con n = " + std::to_string(n));
+
+        bool bounded = true;
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < i; j++) bounded = bounded && std::abs(a[static_cast<std::size_t>(i) * lda + j]) <= 1.0;
+        check(bounded, "pivoteo parcial: |l_ij| <= 1 con n = " + std::to_string(n));
+
+        std::vector<double> serial(static_cast<std::size_t>(n) * n), parallel;
+        for (int i = 0; i < n; i++) std::copy_n(A.row(i), n, serial.data() + static_cast<std::size_t>(i) * n);
+        parallel = serial;
+        std::vector<int> serial_pivots, parallel_pivots;
+        lu_decompose(serial.data(), n, n, serial_pivots, 1);
+        lu_decompose(parallel.data(), n, n, parallel_pivots, 4);
+        check(serial == parallel && serial_pivots == parallel_pivots, "lu_decompose da el mismo factor con 1 y 4 hilos, n = " + std::to_string(n));
+    }
+
+    // PA = LU con las L y U de lu_factorization: cada fila de LU es una fila distinta de A
+    Matrix A = random_matrix(6, 6, 20), L, U;
+    lu_factorization(A, L, U);
+    Matrix LU = L * U;
+    std::vector<bool> used(6, false);
+    int matched = 0;
+    for (int i = 0; i < 6; i++)
+        for (int r = 0; r < 6; r++)
+            if (!used[r] && max_difference(LU.row_view(i), A.row_view(r)) < 1e-14)
+            {
+                used[r] = true;
+                matched++;
+                break;
+            }
+    check(matched == 6, "lu_factorization: L U es A con las filas permutadas");
+    check(L(0, 0) == 1.0 && L(0, 5) == 0.0 && U(5, 0) == 0.0, "lu_factorization: L triangular inferior unitaria, U triangular superior");
+
+    // Una columna nula más allá del primer panel: las operaciones de fila la dejan exactamente en 0
+    const int n = 200;
+    Matrix S = random_matrix(n, n, 21);
+    for (int i = 0; i < n; i++) S(i, 150) = 0.0;
+    std::vector<double> s(static_cast<std::size_t>(n) * n);
+    for (int i = 0; i < n; i++) std::copy_n(S.row(i), n, s.data() + static_cast<std::size_t>(i) * n);
+    std::vector<int> pivots;
+    check(!lu_decompose(s, n, pivots), "lu_decompose detecta el pivote nulo en el segundo panel");
+}
+
+// ---------------------------------------------------------------------
+//  LUDecomposition: un factor para muchos lados derechos (más columnas
+//  que un bloque de solve), determinante con el signo de los pivotes,
+//  inversa, y matrices singulares o no cuadradas
+// ---------------------------------------------------------------------
+
+void test_lu_decomposition()
+{
+    using namespace NumericalAnalysis;
+    const int n = 50, k = 600;
+    Matrix A = random_matrix(n, n, 30);
+    for (int i = 0; i < n; i++) A(i, i) += 4.0;
+    Matrix B = random_matrix(n, k, 31);
+
+    LUDecomposition lu(A);
+    check(!lu.singular() && lu.size() == n, "LUDecomposition factoriza una matriz regular");
+    Matrix X = lu.solve(B);
+    check(X.getRows() == n && X.getCols() == k, "solve(B) retorna n×k");
+    Matrix AX = A * X;
+    check(max_difference(AX, B) < 1e-12, "A X = B con " + std::to_string(k) + " lados derechos");
+
+    bool columns_agree = true;
+    for (int j : {0, 255, 256, 599})
+    {
+        std::vector<double> b(n);
+        for (int i = 0; i < n; i++) b[i] = B(i, j);
+        std::vector<double> x = lu.solve(b);
+        for (int i = 0; i < n; i++) columns_agree = columns_agree && std::abs(x[i] - X(i, j)) < 1e-13;
+    }
+    check(columns_agree, "solve(b) por columna coincide con solve(B)");
+
+    Matrix product = A * lu.inverse();
+    Matrix identity(n, n);
+    for (int i = 0; i < n; i++) identity(i, i) = 1.0;
+    check(max_difference(product, identity) < 1e-12, "A * inverse() = I");
+
+    Matrix eager = A;
+    check_near(lu.determinant(), eager.determinant(), 1e-10, "determinant() coincide con Matrix::determinant");
+    check(LUDecomposition(Matrix({{0, 2}, {3, 1}})).determinant() == -6.0, "determinant() cambia de signo con cada intercambio");
+
+    // lu_substitution con [A|b] da lo mismo que la eliminación gaussiana
+    Matrix augmented(n, n + 1);
+    augmented.block(0, 0, n, n).copy_from(A);
+    augmented.column_view(n).copy_from(B.column_view(0));
+    check(max_difference(lu_substitution(augmented), gaussian_elimination_with_regressive_substitution(augmented)) < 1e-12,
+          "lu_substitution coincide con gaussian_elimination");
+
+    LUDecomposition singular(Matrix({{1, 2}, {2, 4}}));
+    check(singular.singular() && singular.determinant() == 0.0, "matriz singular: singular() y determinante 0");
+    Matrix ones(2, 1);
+    ones.view().fill(1.0);
+    Matrix zeros = singular.solve(ones);
+    check(zeros.getRows() == 2 && zeros(0, 0) == 0.0 && zeros(1, 0) == 0.0, "solve sobre una matriz singular retorna ceros");
+    check(LUDecomposition(Matrix(2, 3)).singular(), "una matriz no cuadrada no se factoriza");
+    check(lu.solve(std::vector<double>(3, 1.0)) == std::vector<double>(n, 0.0), "solve con b de tamaño equivocado retorna ceros");
+}
+
+// ---------------------------------------------------------------------
+//  Expresiones perezosas: el mismo resultado que las operaciones
+//  inmediatas (add, subtract, multiply, transpose), también cuando el
+//  destino aparece en la expresión, y movimientos que no copian
+// ---------------------------------------------------------------------
+
+void test_matrix_expressions()
+{
+    using namespace NumericalAnalysis;
+    Matrix A = random_matrix(7, 5, 40), B = random_matrix(7, 9, 41), C = random_matrix(9, 5, 42), D = random_matrix(7, 5, 43);
+
+    // A + B*C - 2D paso a paso con las operaciones inmediatas
+    Matrix eager = A, product = B, twice = D;
+    product.multiply(C);
+    twice *= 2.0;
+    eager.add(product);
+    eager.subtract(twice);
+    Matrix lazy = A + B * C - 2.0 * D;
+    check(max_difference(lazy, eager) < 1e-14, "A + B*C - 2D coincide con add/multiply/subtract");
+
+    Matrix transposed = A;
+    transposed.transpose();
+    check(max_difference(Matrix(A.t()), transposed) == 0.0, "A.t() coincide con transpose()");
+    Matrix difference = A;
+    difference.subtract(D);
+    difference.transpose();
+    check(max_difference(Matrix((A - D).t()), difference) == 0.0, "(A - D).t() coincide con subtract + transpose");
+    check(max_difference(Matrix((A + D) * C.t()), naive_gemm(1.0, Matrix(A + D), Matrix(C.t()), 0.0, A)) < 1e-14,
+          "(A + D) * C.t() materializa los operandos del producto");
+    check(max_difference(Matrix(-A), Matrix(A * -1.0)) == 0.0, "-A = A * -1");
+
+    // El destino dentro de la expresión
+    Matrix X = random_matrix(6, 6, 44), Y = random_matrix(6, 6, 45);
+    Matrix expected = naive_gemm(1.0, X, X, 0.0, X);
+    X = X * X;
+    check(max_difference(X, expected) < 1e-14, "X = X * X");
+
+    expected = X;
+    expected.transpose();
+    X = X.t();
+    check(max_difference(X, expected) == 0.0, "X = X.t()");
+
+    expected = naive_gemm(1.0, X, Y, 1.0, X);
+    X += X * Y;
+    check(max_difference(X, expected) < 1e-14, "X += X * Y");
+
+    expected = naive_gemm(-1.0, Y, X, 1.0, X);
+    X -= Y * X;
+    check(max_difference(X, expected) < 1e-14, "X -= Y * X");
+
+    Matrix R = random_matrix(3, 8, 46);
+    expected = R;
+    expected.transpose();
+    R = R.t();
+    check(R.getRows() == 8 && R.getCols() == 3 && max_difference(R, expected) == 0.0, "R = R.t() con R no cuadrada");
+
+    expected = X;
+    expected.add(Y);
+    expected.add(Y);
+    X = X + Y + Y;
+    check(max_difference(X, expected) == 0.0, "X = X + Y + Y elemento a elemento en su lugar");
+
+    // Movimientos: el resultado se roba, no se copia
+    Matrix source = random_matrix(4, 4, 47);
+    const double *storage = source.data();
+    Matrix stolen = std::move(source);
+    check(stolen.data() == storage && source.getRows() == 0, "el constructor de movimiento roba el almacenamiento");
+    Matrix target;
+    target = std::move(stolen);
+    check(target.data() == storage && stolen.getRows() == 0, "la asignación por movimiento roba el almacenamiento");
+    Matrix corner = Y.block(0, 0, 4, 4), sum = target;
+    sum.add(corner);
+    check(max_difference(Matrix(std::move(target) + corner), sum) == 0.0, "una temporal movida dentro de la expresión");
+
+    Matrix untouched = A;
+    untouched = A + C;
+    check(max_difference(untouched, A) == 0.0, "dimensiones incompatibles: la asignación no cambia el destino");
+}
+
+// ---------------------------------------------------------------------
+//  Vistas: bloques, filas, columnas y transpuestas sin copia, con sus
+//  strides, escritura a través de la vista y solvers sobre un bloque
+// ---------------------------------------------------------------------
+
+void test_matrix_views()
+{
+    using namespace NumericalAnalysis;
+    Matrix M(5, 7);
+    for (int i = 0; i < 5; i++)
+        for (int j = 0; j < 7; j++) M(i, j) = 10 * i + j;
+
+    MatrixView block = M.block(1, 2, 3, 4);
+    check(block.data() == M.data() + M.stride() + 2 && block.row_stride() == M.stride(), "block apunta dentro de la matriz, sin copia");
+    check(block.getRows() == 3 && block.getCols() == 4 && block(0, 0) == 12 && block(2, 3) == 35, "block(1, 2, 3, 4)");
+    check(M.row_view(3)(0, 4) == 34 && M.row_view(3).getRows() == 1, "row_view");
+    check(M.column_view(5)(4, 0) == 45 && M.column_view(5).getCols() == 1, "column_view");
+
+    ConstMatrixView transposed = M.view().t();
+    check(transposed.getRows() == 7 && transposed.getCols() == 5 && transposed(6, 4) == 46, "t() intercambia dimensiones");
+    check(transposed.row_stride() == 1 && transposed.column_stride() == M.stride(), "t() intercambia los strides");
+    check(transposed.block(1, 0, 2, 3)(0, 2) == 21 && transposed.column_view(2)(3, 0) == 23, "bloques y columnas de una transpuesta");
+    Matrix copied = transposed;
+    check(copied.getRows() == 7 && copied(3, 2) == 23 && copied(6, 0) == 6, "Matrix a partir de una vista con stride de columnas");
+
+    // Escribir por la vista solo toca el bloque
+    block.fill(-1.0);
+    check(M(1, 2) == -1 && M(3, 5) == -1 && M(1, 1) == 11 && M(0, 2) == 2 && M(3, 6) == 36 && M(4, 5) == 45, "fill solo escribe el bloque");
+    M.row_view(0).copy_from(M.view().t().block(0, 4, 7, 1).t());
+    check(M(0, 0) == 40 && M(0, 6) == 46, "copy_from desde una fila transpuesta dos veces");
+
+    check(M.block(4, 0, 2, 1).getRows() == 0, "un bloque fuera de rango da una vista vacía");
+
+    // El destino referenciado por una vista en la expresión
+    Matrix S({{1, 2, 3}, {4, 5, 6}, {7, 8, 9}});
+    S = S.block(1, 1, 2, 2);
+    check(S.getRows() == 2 && S(0, 0) == 5 && S(1, 1) == 9, "S = S.block(...) se evalúa en un temporal");
+
+    // Un [A|b] dentro de una matriz mayor, resuelto sin separarlo
+    Matrix big = random_matrix(9, 10, 50);
+    for (int i = 0; i < 6; i++) big(2 + i, 1 + i) += 3.0;
+    ConstMatrixView augmented = big.block(2, 1, 6, 7);
+    Matrix separate = augmented;
+    check(max_difference(gaussian_elimination_with_regressive_substitution(augmented),
+                         gaussian_elimination_with_regressive_substitution(separate)) == 0.0,
+          "gaussian_elimination sobre un bloque igual que sobre la copia");
+    check(max_difference(lu_substitution(augmented), lu_substitution(separate)) == 0.0, "lu_substitution sobre un bloque igual que sobre la copia");
+
+    // gemm rechaza columnas no contiguas
+    Matrix C(5, 5);
+    C.view().fill(3.0);
+    gemm(1.0, M.view().t().block(0, 0, 5, 5), M.block(0, 0, 5, 5), 0.0, C);
+    check(C(0, 0) == 3.0, "gemm con una transpuesta como vista no toca C");
+}
+
+// ---------------------------------------------------------------------
+//  SmallMatrix / SmallLU: las mismas respuestas que Matrix y
+//  LUDecomposition de 2×2 a 8×8, y el mismo umbral de pivote en los tres
+//  caminos del determinante
+// ---------------------------------------------------------------------
+
+template <int N>
+static void check_small_system(unsigned seed)
+{
+    using namespace NumericalAnalysis;
+    const std::string size = std::to_string(N) + "x" + std::to_string(N);
+    Matrix dynamic = random_matrix(N, N + 1, seed);
+    SmallMatrix<N, N + 1> augmented(dynamic);
+    SmallMatrix<N, N>     A(dynamic.block(0, 0, N, N));
+    Matrix                dense = dynamic.block(0, 0, N, N);
+
+    check(max_difference(lu_substitution(augmented).view(), lu_substitution(dynamic)) < 1e-12, "lu_substitution en la pila = dinámica, " + size);
+    check_near(determinant(A), dense.determinant(), 1e-13, "determinant en la pila = Matrix::determinant, " + size);
+    check(max_difference((inverse(A) * A).view(), SmallMatrix<N, N>::identity().view()) < 1e-10, "inverse(A) * A = I, " + size);
+
+    Matrix product = dense * dense.t();
+    check(max_difference((A * A.transpose()).view(), product) < 1e-14, "producto desenrollado = gemm, " + size);
+    check(max_difference(A.to_matrix(), dense) == 0.0, "to_matrix ida y vuelta, " + size);
+}
+
+void test_small_matrix()
+{
+    using namespace NumericalAnalysis;
+    check_small_system<2>(60);
+    check_small_system<3>(61);
+    check_small_system<4>(62);
+    check_small_system<6>(63);
+    check_small_system<8>(64);
+
+    // Pivote bajo 1e-12: los tres caminos dan 0
+    const SmallMatrix<2, 2> tiny = {1e-13, 0, 0, 1};
+    check(determinant(tiny) == 0.0, "determinant<2> con pivote 1e-13 da 0");
+    check(SmallLU<2>(tiny).determinant() == 0.0 && SmallLU<2>(tiny).singular(), "SmallLU<2> con pivote 1e-13 es singular");
+    check(tiny.to_matrix().determinant() == 0.0, "Matrix::determinant con pivote 1e-13 da 0");
+    const SmallMatrix<3, 3> tiny3 = {1, 0, 0,  0, 1e-13, 0,  0, 0, 1};
+    check(determinant(tiny3) == 0.0 && tiny3.to_matrix().determinant() == 0.0, "determinant<3> con pivote 1e-13 da 0 como Matrix");
+
+    const SmallMatrix<3, 3> swapped = {0, 1, 0,  1, 0, 0,  0, 0, 2};
+    check(determinant(swapped) == -2.0, "determinant<3> con un intercambio de filas");
+
+    const SmallMatrix<2, 2> singular = {1, 2, 2, 4};
+    check(inverse(singular).to_matrix()(0, 0) == 0.0, "inverse de una matriz singular retorna ceros");
+    check(SmallMatrix<2, 2>(Matrix(3, 3))(0, 0) == 0.0, "SmallMatrix de una Matrix de otras dimensiones queda en 0");
+}
+
+// ---------------------------------------------------------------------
+//  solve_batched: cada sistema del lote (intercalado SoA, con una
+//  cantidad que no llena el último bloque de carriles) da lo mismo que
+//  gaussian_elimination_with_regressive_substitution, incluidos los
+//  sistemas que piden intercambio de filas y los singulares
+// ---------------------------------------------------------------------
+
+void test_solve_batched()
+{
+    using namespace NumericalAnalysis;
+    const std::size_t count = 203;
+    for (int n = 3; n <= 6; n++)
+    {
+        const int cols = n + 1;
+        std::vector<Matrix> systems;
+        std::vector<double> augmented(static_cast<std::size_t>(n) * cols * count);
+        for (std::size_t k = 0; k < count; k++)
+        {
+            Matrix system = random_matrix(n, cols, static_cast<unsigned>(1000 * n + k));
+            if (k % 7 == 1)                                  // a_00 = 0: intercambio en el primer paso
+                system(0, 0) = 0.0;
+            if (k % 11 == 2)                                 // dos filas iguales: sin solución única
+                system.row_view(n - 1).copy_from(system.row_view(0));
+            for (int i = 0; i < n; i++)
+                for (int j = 0; j < cols; j++) augmented[(static_cast<std::size_t>(i) * cols + j) * count + k] = system(i, j);
+            systems.push_back(system);
+        }
+
+        std::vector<double>        solutions(static_cast<std::size_t>(n) * count);
+        std::vector<unsigned char> singular(count, 0);
+        const int failures = solve_batched(n, count, augmented.data(), solutions.data(), singular.data());
+
+        int  expected_failures = 0;
+        bool agree = true, flags = true;
+        for (std::size_t k = 0; k < count; k++)
+        {
+            const bool duplicated = k % 11 == 2;
+            expected_failures += duplicated;
+            flags = flags && (singular[k] != 0) == duplicated;
+
+            Matrix reference = duplicated ? Matrix(n, 1) : gaussian_elimination_with_regressive_substitution(systems[k]);
+            for (int i = 0; i < n; i++)
+                agree = agree && std::abs(solutions[i * count + k] - reference(i, 0)) <= 1e-12 * std::max(1.0, std::abs(reference(i, 0)));
+        }
+        const std::string size = "n = " + std::to_string(n);
+        check(agree, "solve_batched coincide con gaussian_elimination sistema por sistema, " + size);
+        check(flags && failures == expected_failures, "solve_batched marca los sistemas singulares, " + size);
+
+        check(solve_batched(n, count, augmented, 1) == solve_batched(n, count, augmented, 4), "solve_batched da lo mismo con 1 y 4 hilos, " + size);
+    }
+
+    std::vector<double> wrong = solve_batched(3, 5, std::vector<double>(10, 1.0));
+    check(wrong.size() == 15 && std::all_of(wrong.begin(), wrong.end(), [](double v) { return v == 0.0; }),
+          "solve_batched con un buffer de tamaño equivocado retorna ceros");
+}
+
+int run_tests()
+{
+    checks_run    = 0;
+    checks_failed = 0;
+
+    test_function_program();
+    test_evaluate_many();
+    test_polynomial_horner();
+    test_automatic_differentiation();
+    test_expression_parser();
+    test_expression_simplifier();
+    test_static_expressions();
+    test_generic_callables();
+    test_evaluation_cache();
+    test_interval_arithmetic();
+    test_parallel_batch();
+    test_find_all_roots();
+    test_bracketing_hybrids();
+    test_root_status();
+    test_polynomial_roots();
+    test_nonlinear_systems();
+    test_parameter_continuation();
+    test_matrix_storage();
+    test_gemm();
+    test_blocked_lu();
+    test_lu_decomposition();
+    test_matrix_expressions();
+    test_matrix_views();
+    test_small_matrix();
+    test_solve_batched();
+
+    std::cout << "Pruebas: " << (checks_run - checks_failed) << " de " << checks_run << " correctas\n";
+    return checks_failed;
+}
@@ -0,0 +1,32 @@
+#ifndef TESTS_H
+#define TESTS_H
+
+    // Se ejecutan con ./programa --test; retorna la cantidad de fallos
+    int  run_tests();
+    void test_function_program();
+    void test_evaluate_many();
+    void test_polynomial_horner();
+    void test_automatic_differentiation();
+    void test_expression_parser();
+    void test_expression_simplifier();
+    void test_static_expressions();
+    void test_generic_callables();
+    void test_evaluation_cache();
+    void test_interval_arithmetic();
+    void test_parallel_batch();
+    void test_find_all_roots();
+    void test_bracketing_hybrids();
+    void test_root_status();
+    void test_polynomial_roots();
+    void test_nonlinear_systems();
+    void test_parameter_continuation();
+    void test_matrix_storage();
+    void test_gemm();
+    void test_blocked_lu();
+    void test_lu_decomposition();
+    void test_matrix_expressions();
+    void test_matrix_views();
+    void test_small_matrix();
+    void test_solve_batched();
+
+#endif